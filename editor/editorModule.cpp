@@ -102,8 +102,9 @@ void EditorModule::generate (double x, double y, double width, double height, in
 
 	unsigned char *pixels = (unsigned char *)malloc(w*h*3);
 
+	// renders straight into the buffer handed to wxImage
 	noisepp::utils::Image img;
-	img.create (w, h);
+	img.setExternalData (pixels, w, h);
 
 	noisepp::utils::GradientRenderer gradients;
 	gradients.addGradient (-1.0, noisepp::utils::ColourValue(0.0f, 0.0f, 0.0f));
@@ -123,8 +124,6 @@ void EditorModule::generate (double x, double y, double width, double height, in
 	gradients.addGradient ( 1.0000, noisepp::utils::ColourValue (255, 255, 255)/255.f); // snow*/
 	gradients.renderImage (img, mData);
 
-	std::memcpy (pixels, img.getPixelData(), w*h*3);
-
 	mImage = new wxImage (w, h, pixels);
 	mBitmap = new wxBitmap (*mImage);
 	/*glGenTextures (1, &mTexture);
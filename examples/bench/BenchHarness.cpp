@@ -0,0 +1,164 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Noise.h"
+
+namespace bench
+{
+
+Statistics Statistics::calculate (std::vector<double> values)
+{
+	Statistics s;
+	if (values.empty())
+		return s;
+	std::sort (values.begin(), values.end());
+	s.min = values.front();
+	s.max = values.back();
+	double sum = 0;
+	for (size_t i=0;i<values.size();++i)
+		sum += values[i];
+	s.mean = sum / values.size();
+	double var = 0;
+	for (size_t i=0;i<values.size();++i)
+		var += (values[i]-s.mean)*(values[i]-s.mean);
+	s.stddev = values.size() > 1 ? std::sqrt(var / (values.size()-1)) : 0;
+	s.median = percentile (values, 50);
+	s.p90 = percentile (values, 90);
+	s.p99 = percentile (values, 99);
+	return s;
+}
+
+double Statistics::percentile (const std::vector<double> &sorted, double p)
+{
+	if (sorted.empty())
+		return 0;
+	const double pos = (p / 100.0) * (sorted.size()-1);
+	const size_t i = size_t(pos);
+	if (i+1 >= sorted.size())
+		return sorted.back();
+	const double t = pos - i;
+	return sorted[i] + (sorted[i+1]-sorted[i]) * t;
+}
+
+Harness::Harness () : mRepetitions(15), mWarmupTime(0.1), mMinRepetitionTime(0.002), mVerbose(false), mCounters(NULL)
+{
+}
+
+void Harness::setRepetitions (int v)
+{
+	mRepetitions = std::max(v, 1);
+}
+
+void Harness::setWarmupTime (double v)
+{
+	mWarmupTime = v;
+}
+
+void Harness::setMinRepetitionTime (double v)
+{
+	mMinRepetitionTime = v;
+}
+
+void Harness::setVerbose (bool v)
+{
+	mVerbose = v;
+}
+
+void Harness::setCounters (PerfCounters *counters)
+{
+	mCounters = counters;
+}
+
+Result Harness::measure (Case &c)
+{
+	Result r;
+	r.name = c.name;
+	r.dimension = c.dimension;
+	r.path = c.path;
+	r.module = c.module;
+	r.quality = c.quality;
+	r.depth = c.depth;
+	r.threads = c.threads;
+
+	if (mVerbose)
+	{
+		std::cerr << c.name << " ... ";
+		std::cerr.flush ();
+	}
+
+	c.setup ();
+
+	// warm-up: brings caches, branch predictors and the CPU clock into a steady state
+	// and tells us how long a single run takes
+	int warmupRuns = 0;
+	const double warmupStart = noisepp::Timer::getTime();
+	double elapsed = 0;
+	do
+	{
+		c.run ();
+		++warmupRuns;
+		elapsed = noisepp::Timer::getTime() - warmupStart;
+	}
+	while (elapsed < mWarmupTime);
+
+	// short cases are repeated to stay well above the timer resolution
+	const double perRun = elapsed / warmupRuns;
+	int iterations = 1;
+	if (perRun > 0 && perRun < mMinRepetitionTime)
+		iterations = int(std::ceil(mMinRepetitionTime / perRun));
+
+	const double samples = double(c.getSampleCount()) * iterations;
+	std::vector<double> times;
+	times.reserve (mRepetitions);
+	if (mCounters)
+		mCounters->start ();
+	for (int rep=0;rep<mRepetitions;++rep)
+	{
+		const double start = noisepp::Timer::getTime();
+		for (int i=0;i<iterations;++i)
+			c.run ();
+		const double t = noisepp::Timer::getTime() - start;
+		times.push_back (t * 1.0e9 / samples);
+		// outside of the measured time, the checksum walks the whole output
+		r.checksum += c.getChecksum ();
+	}
+	if (mCounters)
+	{
+		r.counters = mCounters->stop();
+		for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+		{
+			if (r.counters.values[i] >= 0)
+				r.counters.values[i] /= samples * mRepetitions;
+		}
+	}
+
+	c.teardown ();
+
+	r.samples = samples;
+	r.iterations = iterations;
+	r.repetitions = mRepetitions;
+	r.time = Statistics::calculate (times);
+	r.throughput = r.time.median > 0 ? 1.0e3 / r.time.median : 0;
+
+	if (mVerbose)
+	{
+		std::cerr << r.time.median << " ns/sample";
+		if (r.counters.isValid())
+		{
+			if (r.counters.getIPC() >= 0)
+				std::cerr << ", IPC " << r.counters.getIPC();
+			for (int i=CounterValues::L1D_MISSES;i<CounterValues::COUNTER_COUNT;++i)
+			{
+				if (r.counters.values[i] >= 0)
+					std::cerr << ", " << r.counters.values[i] << " " << CounterValues::getName(i) << "/sample";
+			}
+		}
+		std::cerr << std::endl;
+	}
+	return r;
+}
+
+};
@@ -0,0 +1,132 @@
+#ifndef BENCHHARNESS_H
+#define BENCHHARNESS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "BenchPerfCounters.h"
+
+namespace bench
+{
+
+/// A single benchmark case.
+/// A case builds its pipelines in setup() and evaluates a fixed amount of samples per run() call.
+class Case
+{
+	public:
+		/// Full case name, used to match results against a baseline.
+		std::string name;
+		/// Dimension of the evaluated pipeline (1, 2 or 3).
+		int dimension;
+		/// Evaluation path (point, line, grid or threaded).
+		std::string path;
+		/// Name of the module under test.
+		std::string module;
+		/// Noise quality, -1 if the module has no quality setting.
+		int quality;
+		/// Number of layers in the module graph.
+		int depth;
+		/// Number of worker threads.
+		int threads;
+
+		Case () : dimension(0), quality(-1), depth(1), threads(1)
+		{}
+		virtual ~Case ()
+		{}
+		/// Prepares the case, not measured.
+		virtual void setup ()
+		{}
+		/// Evaluates getSampleCount() samples.
+		virtual void run () = 0;
+		/// Releases everything created in setup().
+		virtual void teardown ()
+		{}
+		/// Returns the number of samples evaluated by one run() call.
+		virtual size_t getSampleCount () const = 0;
+		/// Returns a checksum of the output of the last run.
+		/// The harness sums it up over the repetitions and reports it, so the work can't be dropped and different builds can be checked for equal output.
+		virtual double getChecksum () const
+		{
+			return 0;
+		}
+};
+
+/// Summary statistics of the repetitions, all times in nanoseconds per sample.
+struct Statistics
+{
+	double min;
+	double max;
+	double mean;
+	double median;
+	double p90;
+	double p99;
+	double stddev;
+
+	Statistics () : min(0), max(0), mean(0), median(0), p90(0), p99(0), stddev(0)
+	{}
+	/// Calculates the statistics of the specified values.
+	static Statistics calculate (std::vector<double> values);
+	/// Returns the specified percentile (0-100) of sorted values using linear interpolation.
+	static double percentile (const std::vector<double> &sorted, double p);
+};
+
+/// The measurement result of one case.
+struct Result
+{
+	std::string name;
+	int dimension;
+	std::string path;
+	std::string module;
+	int quality;
+	int depth;
+	int threads;
+	/// Samples evaluated per repetition.
+	double samples;
+	/// run() calls per repetition.
+	int iterations;
+	/// Number of measured repetitions.
+	int repetitions;
+	/// Nanoseconds per sample.
+	Statistics time;
+	/// Million samples per second, based on the median.
+	double throughput;
+	/// Hardware counters per sample over all repetitions, invalid if not measured.
+	CounterValues counters;
+	/// Sum of Case::getChecksum() after every measured repetition.
+	double checksum;
+
+	Result () : dimension(0), quality(-1), depth(1), threads(1), samples(0), iterations(0), repetitions(0), throughput(0), checksum(0)
+	{}
+};
+
+/// Runs cases with warm-up and repetitions.
+class Harness
+{
+	private:
+		int mRepetitions;
+		double mWarmupTime;
+		double mMinRepetitionTime;
+		bool mVerbose;
+		PerfCounters *mCounters;
+
+	public:
+		Harness ();
+		/// Sets the number of measured repetitions.
+		void setRepetitions (int v);
+		/// Sets the minimum warm-up time in seconds.
+		void setWarmupTime (double v);
+		/// Sets the minimum duration of a repetition in seconds.
+		/// Short cases are called several times per repetition to reach it.
+		void setMinRepetitionTime (double v);
+		/// Enables progress output on stderr.
+		void setVerbose (bool v);
+		/// Sets open hardware counters to read around the measured repetitions, NULL to disable.
+		void setCounters (PerfCounters *counters);
+		/// Measures the specified case.
+		Result measure (Case &c);
+};
+
+};
+
+#endif // BENCHHARNESS_H
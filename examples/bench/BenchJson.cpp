@@ -0,0 +1,467 @@
+#include "BenchJson.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace bench
+{
+
+namespace
+{
+
+class Parser
+{
+	private:
+		const char *mPos;
+		const char *mEnd;
+		std::string mError;
+
+		void skipWhitespace ()
+		{
+			while (mPos < mEnd && (*mPos == ' ' || *mPos == '\t' || *mPos == '\r' || *mPos == '\n'))
+				++mPos;
+		}
+		bool fail (const char *msg)
+		{
+			if (mError.empty())
+				mError = msg;
+			return false;
+		}
+		bool expect (const char *word)
+		{
+			for (;*word;++word,++mPos)
+			{
+				if (mPos >= mEnd || *mPos != *word)
+					return fail ("invalid literal");
+			}
+			return true;
+		}
+		bool parseString (std::string &s)
+		{
+			if (mPos >= mEnd || *mPos != '"')
+				return fail ("string expected");
+			++mPos;
+			s.clear ();
+			while (mPos < mEnd && *mPos != '"')
+			{
+				char c = *mPos++;
+				if (c == '\\')
+				{
+					if (mPos >= mEnd)
+						return fail ("unterminated string");
+					c = *mPos++;
+					switch (c)
+					{
+						case 'n': c = '\n'; break;
+						case 't': c = '\t'; break;
+						case 'r': c = '\r'; break;
+						case 'b': c = '\b'; break;
+						case 'f': c = '\f'; break;
+						case 'u':
+							// the benchmark only writes ASCII, keep the code point if it fits
+							if (mEnd - mPos < 4)
+								return fail ("invalid escape");
+							c = char(strtol(std::string(mPos, 4).c_str(), NULL, 16) & 0x7F);
+							mPos += 4;
+							break;
+						default: break;
+					}
+				}
+				s += c;
+			}
+			if (mPos >= mEnd)
+				return fail ("unterminated string");
+			++mPos;
+			return true;
+		}
+		bool parseValue (JsonValue &v)
+		{
+			skipWhitespace ();
+			if (mPos >= mEnd)
+				return fail ("unexpected end of input");
+			switch (*mPos)
+			{
+				case '{':
+				{
+					v.type = JsonValue::JSON_OBJECT;
+					++mPos;
+					skipWhitespace ();
+					if (mPos < mEnd && *mPos == '}')
+					{
+						++mPos;
+						return true;
+					}
+					for (;;)
+					{
+						skipWhitespace ();
+						std::pair<std::string, JsonValue> member;
+						if (!parseString(member.first))
+							return false;
+						skipWhitespace ();
+						if (mPos >= mEnd || *mPos != ':')
+							return fail ("':' expected");
+						++mPos;
+						if (!parseValue(member.second))
+							return false;
+						v.members.push_back (member);
+						skipWhitespace ();
+						if (mPos < mEnd && *mPos == ',')
+						{
+							++mPos;
+							continue;
+						}
+						if (mPos < mEnd && *mPos == '}')
+						{
+							++mPos;
+							return true;
+						}
+						return fail ("',' or '}' expected");
+					}
+				}
+				case '[':
+				{
+					v.type = JsonValue::JSON_ARRAY;
+					++mPos;
+					skipWhitespace ();
+					if (mPos < mEnd && *mPos == ']')
+					{
+						++mPos;
+						return true;
+					}
+					for (;;)
+					{
+						v.elements.push_back (JsonValue());
+						if (!parseValue(v.elements.back()))
+							return false;
+						skipWhitespace ();
+						if (mPos < mEnd && *mPos == ',')
+						{
+							++mPos;
+							continue;
+						}
+						if (mPos < mEnd && *mPos == ']')
+						{
+							++mPos;
+							return true;
+						}
+						return fail ("',' or ']' expected");
+					}
+				}
+				case '"':
+					v.type = JsonValue::JSON_STRING;
+					return parseString (v.string);
+				case 't':
+					v.type = JsonValue::JSON_BOOL;
+					v.boolean = true;
+					return expect ("true");
+				case 'f':
+					v.type = JsonValue::JSON_BOOL;
+					v.boolean = false;
+					return expect ("false");
+				case 'n':
+					v.type = JsonValue::JSON_NULL;
+					return expect ("null");
+				default:
+				{
+					char *end = NULL;
+					const std::string rest(mPos, std::min<size_t>(mEnd-mPos, 64));
+					v.type = JsonValue::JSON_NUMBER;
+					v.number = strtod (rest.c_str(), &end);
+					if (end == rest.c_str())
+						return fail ("invalid value");
+					mPos += end - rest.c_str();
+					return true;
+				}
+			}
+		}
+
+	public:
+		Parser (const std::string &text) : mPos(text.c_str()), mEnd(text.c_str()+text.size())
+		{}
+		bool parse (JsonValue &v)
+		{
+			if (!parseValue(v))
+				return false;
+			skipWhitespace ();
+			if (mPos != mEnd)
+				return fail ("trailing characters");
+			return true;
+		}
+		const std::string &getError () const
+		{
+			return mError;
+		}
+};
+
+void writeNumber (std::ostream &out, double v)
+{
+	// JSON has no representation for nan or inf
+	if (v != v || v > 1.0e300 || v < -1.0e300)
+		out << "null";
+	else
+		out << v;
+}
+
+/// Writes a counter value, negative values mark unavailable counters.
+void writeCounter (std::ostream &out, double v)
+{
+	if (v < 0)
+		out << "null";
+	else
+		writeNumber (out, v);
+}
+
+};
+
+const JsonValue *JsonValue::get (const std::string &name) const
+{
+	for (size_t i=0;i<members.size();++i)
+	{
+		if (members[i].first == name)
+			return &members[i].second;
+	}
+	return NULL;
+}
+
+double JsonValue::getNumber (const std::string &name, double def) const
+{
+	const JsonValue *v = get(name);
+	return (v && v->type == JSON_NUMBER) ? v->number : def;
+}
+
+std::string JsonValue::getString (const std::string &name, const std::string &def) const
+{
+	const JsonValue *v = get(name);
+	return (v && v->type == JSON_STRING) ? v->string : def;
+}
+
+bool JsonValue::parse (const std::string &text, JsonValue &value, std::string &error)
+{
+	Parser parser(text);
+	if (!parser.parse(value))
+	{
+		error = parser.getError();
+		return false;
+	}
+	return true;
+}
+
+std::string JsonValue::quote (const std::string &s)
+{
+	std::string r = "\"";
+	for (size_t i=0;i<s.size();++i)
+	{
+		const char c = s[i];
+		switch (c)
+		{
+			case '"': r += "\\\""; break;
+			case '\\': r += "\\\\"; break;
+			case '\n': r += "\\n"; break;
+			case '\t': r += "\\t"; break;
+			case '\r': r += "\\r"; break;
+			default:
+				if ((unsigned char)c < 0x20)
+				{
+					char buf[8];
+					sprintf (buf, "\\u%04x", (unsigned)c);
+					r += buf;
+				}
+				else
+					r += c;
+		}
+	}
+	r += "\"";
+	return r;
+}
+
+void writeResults (std::ostream &out, const RunInfo &info, const std::vector<Result> &results)
+{
+	writeResults (out, info, results, std::vector<ScalingResult>(), std::vector<LatencyResult>());
+}
+
+void writeResults (std::ostream &out, const RunInfo &info, const std::vector<Result> &results, const std::vector<ScalingResult> &scaling,
+	const std::vector<LatencyResult> &latency)
+{
+	out << std::setprecision(6);
+	out << "{\n";
+	out << "\t\"format\": \"noisepp-bench\",\n";
+	out << "\t\"version\": 1,\n";
+	out << "\t\"info\": {";
+	out << "\"hardware_threads\": " << info.hardwareThreads;
+	out << ", \"repetitions\": " << info.repetitions;
+	out << ", \"warmup_time\": " << info.warmupTime;
+	out << ", \"double_precision\": " << (info.doublePrecision ? "true" : "false");
+	out << ", \"timer_overhead_ns\": "; writeNumber (out, info.timerOverhead);
+	out << "},\n";
+	out << "\t\"results\": [";
+	for (size_t i=0;i<results.size();++i)
+	{
+		const Result &r = results[i];
+		out << (i ? ",\n" : "\n");
+		out << "\t\t{\"name\": " << JsonValue::quote(r.name);
+		out << ", \"dimension\": " << r.dimension;
+		out << ", \"path\": " << JsonValue::quote(r.path);
+		out << ", \"module\": " << JsonValue::quote(r.module);
+		out << ", \"quality\": " << r.quality;
+		out << ", \"depth\": " << r.depth;
+		out << ", \"threads\": " << r.threads;
+		out << ", \"samples\": "; writeNumber (out, r.samples);
+		out << ", \"iterations\": " << r.iterations;
+		out << ", \"repetitions\": " << r.repetitions;
+		out << ", \"min_ns\": "; writeNumber (out, r.time.min);
+		out << ", \"median_ns\": "; writeNumber (out, r.time.median);
+		out << ", \"mean_ns\": "; writeNumber (out, r.time.mean);
+		out << ", \"p90_ns\": "; writeNumber (out, r.time.p90);
+		out << ", \"p99_ns\": "; writeNumber (out, r.time.p99);
+		out << ", \"max_ns\": "; writeNumber (out, r.time.max);
+		out << ", \"stddev_ns\": "; writeNumber (out, r.time.stddev);
+		out << ", \"msamples_per_sec\": "; writeNumber (out, r.throughput);
+		out << ", \"checksum\": "; writeNumber (out, r.checksum);
+		if (r.counters.isValid())
+		{
+			out << ", \"counters\": {";
+			for (int c=0;c<CounterValues::COUNTER_COUNT;++c)
+			{
+				out << "\"" << CounterValues::getName(c) << "\": ";
+				writeCounter (out, r.counters.values[c]);
+				out << ", ";
+			}
+			out << "\"ipc\": ";
+			writeCounter (out, r.counters.getIPC());
+			out << "}";
+		}
+		out << "}";
+	}
+	out << "\n\t]";
+	if (!scaling.empty())
+	{
+		out << ",\n\t\"scaling\": [";
+		for (size_t i=0;i<scaling.size();++i)
+		{
+			const ScalingResult &r = scaling[i];
+			out << (i ? ",\n" : "\n");
+			out << "\t\t{\"name\": " << JsonValue::quote(r.timing.name);
+			out << ", \"workload\": " << JsonValue::quote(r.workload);
+			out << ", \"tile_size\": " << r.tileSize;
+			out << ", \"depth\": " << r.timing.depth;
+			out << ", \"threads\": " << r.timing.threads;
+			out << ", \"msamples_per_sec\": "; writeNumber (out, r.timing.throughput);
+			out << ", \"speedup\": "; writeNumber (out, r.speedup);
+			out << ", \"efficiency\": "; writeNumber (out, r.efficiency);
+			out << ", \"lock_wait_ms\": "; writeNumber (out, r.lockWait*1.0e3);
+			out << ", \"main_wait_ms\": "; writeNumber (out, r.mainWait*1.0e3);
+			out << ", \"utilization\": [";
+			for (size_t t=0;t<r.utilization.size();++t)
+			{
+				if (t)
+					out << ", ";
+				writeNumber (out, r.utilization[t]);
+			}
+			out << "]}";
+		}
+		out << "\n\t]";
+	}
+	if (!latency.empty())
+	{
+		out << ",\n\t\"latency\": [";
+		for (size_t i=0;i<latency.size();++i)
+		{
+			const LatencyResult &r = latency[i];
+			out << (i ? ",\n" : "\n");
+			out << "\t\t{\"name\": " << JsonValue::quote(r.name);
+			out << ", \"mode\": " << JsonValue::quote(r.mode);
+			out << ", \"dimension\": " << r.dimension;
+			out << ", \"depth\": " << r.depth;
+			out << ", \"threads\": " << r.threads;
+			out << ", \"queries\": "; writeNumber (out, r.queries);
+			out << ", \"mean_ns\": "; writeNumber (out, r.mean);
+			out << ", \"p50_ns\": "; writeNumber (out, r.p50);
+			out << ", \"p90_ns\": "; writeNumber (out, r.p90);
+			out << ", \"p99_ns\": "; writeNumber (out, r.p99);
+			out << ", \"p999_ns\": "; writeNumber (out, r.p999);
+			out << ", \"max_ns\": "; writeNumber (out, r.max);
+			// bucket i counts latencies in [2^i, 2^(i+1)) ns, trailing empty buckets are left out
+			size_t used = r.histogram.size();
+			while (used > 0 && r.histogram[used-1] == 0)
+				--used;
+			out << ", \"histogram_log2_ns\": [";
+			for (size_t b=0;b<used;++b)
+			{
+				if (b)
+					out << ", ";
+				writeNumber (out, r.histogram[b]);
+			}
+			out << "]}";
+		}
+		out << "\n\t]";
+	}
+	out << "\n}\n";
+}
+
+bool readResults (const std::string &filename, std::vector<Result> &results, std::string &error)
+{
+	std::ifstream f(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!f)
+	{
+		error = "can't open " + filename;
+		return false;
+	}
+	std::stringstream ss;
+	ss << f.rdbuf();
+
+	JsonValue root;
+	if (!JsonValue::parse(ss.str(), root, error))
+		return false;
+	if (root.type != JsonValue::JSON_OBJECT || root.getString("format") != "noisepp-bench")
+	{
+		error = filename + " is not a benchmark result file";
+		return false;
+	}
+	const JsonValue *list = root.get("results");
+	if (!list || list->type != JsonValue::JSON_ARRAY)
+	{
+		error = filename + " has no results";
+		return false;
+	}
+	for (size_t i=0;i<list->elements.size();++i)
+	{
+		const JsonValue &v = list->elements[i];
+		if (v.type != JsonValue::JSON_OBJECT)
+			continue;
+		Result r;
+		r.name = v.getString("name");
+		r.dimension = int(v.getNumber("dimension"));
+		r.path = v.getString("path");
+		r.module = v.getString("module");
+		r.quality = int(v.getNumber("quality", -1));
+		r.depth = int(v.getNumber("depth", 1));
+		r.threads = int(v.getNumber("threads", 1));
+		r.samples = v.getNumber("samples");
+		r.iterations = int(v.getNumber("iterations"));
+		r.repetitions = int(v.getNumber("repetitions"));
+		r.time.min = v.getNumber("min_ns");
+		r.time.median = v.getNumber("median_ns");
+		r.time.mean = v.getNumber("mean_ns");
+		r.time.p90 = v.getNumber("p90_ns");
+		r.time.p99 = v.getNumber("p99_ns");
+		r.time.max = v.getNumber("max_ns");
+		r.time.stddev = v.getNumber("stddev_ns");
+		r.throughput = v.getNumber("msamples_per_sec");
+		r.checksum = v.getNumber("checksum", 0);
+		const JsonValue *counters = v.get("counters");
+		if (counters && counters->type == JsonValue::JSON_OBJECT)
+		{
+			for (int c=0;c<CounterValues::COUNTER_COUNT;++c)
+				r.counters.values[c] = counters->getNumber(CounterValues::getName(c), -1);
+		}
+		results.push_back (r);
+	}
+	return true;
+}
+
+};
@@ -0,0 +1,68 @@
+#ifndef BENCHJSON_H
+#define BENCHJSON_H
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "BenchLatency.h"
+#include "BenchScaling.h"
+
+namespace bench
+{
+
+/// Minimal JSON value, enough to read back the files written by the benchmark.
+class JsonValue
+{
+	public:
+		enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+
+		Type type;
+		bool boolean;
+		double number;
+		std::string string;
+		std::vector<JsonValue> elements;
+		std::vector<std::pair<std::string, JsonValue> > members;
+
+		JsonValue () : type(JSON_NULL), boolean(false), number(0)
+		{}
+		/// Returns the member with the specified name or NULL.
+		const JsonValue *get (const std::string &name) const;
+		/// Returns the numeric member with the specified name or the default value.
+		double getNumber (const std::string &name, double def=0) const;
+		/// Returns the string member with the specified name or the default value.
+		std::string getString (const std::string &name, const std::string &def="") const;
+
+		/// Parses the specified text, returns false and sets error on failure.
+		static bool parse (const std::string &text, JsonValue &value, std::string &error);
+		/// Returns the escaped and quoted string.
+		static std::string quote (const std::string &s);
+};
+
+/// Information about the benchmark run stored next to the results.
+struct RunInfo
+{
+	int hardwareThreads;
+	int repetitions;
+	double warmupTime;
+	bool doublePrecision;
+	/// Cost of one timer reading in nanoseconds.
+	double timerOverhead;
+
+	RunInfo () : hardwareThreads(1), repetitions(0), warmupTime(0), doublePrecision(false), timerOverhead(0)
+	{}
+};
+
+/// Writes the results as JSON.
+void writeResults (std::ostream &out, const RunInfo &info, const std::vector<Result> &results);
+/// Writes the results, the thread scaling and the latency results as JSON.
+void writeResults (std::ostream &out, const RunInfo &info, const std::vector<Result> &results, const std::vector<ScalingResult> &scaling,
+	const std::vector<LatencyResult> &latency);
+/// Reads results written by writeResults().
+bool readResults (const std::string &filename, std::vector<Result> &results, std::string &error);
+
+};
+
+#endif // BENCHJSON_H
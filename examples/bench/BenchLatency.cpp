@@ -0,0 +1,286 @@
+#include "BenchLatency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Noise.h"
+
+#include "BenchHarness.h"
+#include "BenchSuite.h"
+
+namespace bench
+{
+
+using namespace noisepp;
+
+namespace
+{
+
+/// Queries run by every thread before the measurement, they create the caches.
+const int WARMUP_QUERIES = 1000;
+const int HISTOGRAM_BUCKETS = 32;
+const Real EXTENT = 64.0;
+
+template <int D>
+struct QueryDimension;
+
+template <>
+struct QueryDimension<2>
+{
+	typedef Pipeline2D Pipeline;
+	typedef PipelineElement2D Element;
+	typedef PointQuery2D Query;
+	static Real query (const Query &q, const Real *p)
+	{
+		return q.getValue (p[0], p[1]);
+	}
+	static Real query (const Pipeline *pipe, Element *e, Cache *cache, const Real *p)
+	{
+		pipe->cleanCache (cache);
+		return e->getValue (p[0], p[1], cache);
+	}
+};
+
+template <>
+struct QueryDimension<3>
+{
+	typedef Pipeline3D Pipeline;
+	typedef PipelineElement3D Element;
+	typedef PointQuery3D Query;
+	static Real query (const Query &q, const Real *p)
+	{
+		return q.getValue (p[0], p[1], p[2]);
+	}
+	static Real query (const Pipeline *pipe, Element *e, Cache *cache, const Real *p)
+	{
+		pipe->cleanCache (cache);
+		return e->getValue (p[0], p[1], p[2], cache);
+	}
+};
+
+#if NOISEPP_ENABLE_THREADS
+/// Lets all threads start measuring at the same time.
+class StartBarrier
+{
+	private:
+		threadpp::Mutex mMutex;
+		threadpp::Condition mCond;
+		int mReady;
+		bool mGo;
+
+	public:
+		StartBarrier () : mReady(0), mGo(false)
+		{}
+		/// Called by the workers.
+		void arrive ()
+		{
+			threadpp::Mutex::Lock lk(mMutex);
+			++mReady;
+			mCond.notifyAll ();
+			while (!mGo)
+				mCond.wait (lk);
+		}
+		/// Called by the main thread, returns when all workers arrived and releases them.
+		void release (int count)
+		{
+			threadpp::Mutex::Lock lk(mMutex);
+			while (mReady < count)
+				mCond.wait (lk);
+			mGo = true;
+			mCond.notifyAll ();
+		}
+};
+#endif
+
+template <int D>
+class Worker
+{
+	private:
+		typedef QueryDimension<D> Dim;
+
+	public:
+		const typename Dim::Pipeline *pipe;
+		typename Dim::Element *element;
+		const typename Dim::Query *query;
+#if NOISEPP_ENABLE_THREADS
+		StartBarrier *barrier;
+#endif
+		int count;
+		unsigned seed;
+		std::vector<double> samples;
+		double checksum;
+
+		Worker () : pipe(NULL), element(NULL), query(NULL), count(0), seed(1), checksum(0)
+		{
+#if NOISEPP_ENABLE_THREADS
+			barrier = NULL;
+#endif
+		}
+		static void *entry (void *worker)
+		{
+			static_cast<Worker<D>*>(worker)->run ();
+			return NULL;
+		}
+		void run ()
+		{
+			// everything is allocated up front so only the query itself is measured
+			const int total = WARMUP_QUERIES + count;
+			std::vector<Real> coords(total*D);
+			for (size_t i=0;i<coords.size();++i)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				coords[i] = Real(seed >> 8) / Real(1 << 24) * EXTENT;
+			}
+			samples.resize (count);
+			Cache *cache = query ? NULL : pipe->createCache();
+
+			const Real *p = &coords[0];
+			for (int i=0;i<WARMUP_QUERIES;++i,p+=D)
+				checksum += query ? Dim::query(*query, p) : Dim::query(pipe, element, cache, p);
+#if NOISEPP_ENABLE_THREADS
+			if (barrier)
+				barrier->arrive ();
+#endif
+			for (int i=0;i<count;++i,p+=D)
+			{
+				const double start = Timer::getTime();
+				checksum += query ? Dim::query(*query, p) : Dim::query(pipe, element, cache, p);
+				samples[i] = (Timer::getTime() - start) * 1.0e9;
+			}
+			if (cache)
+				pipe->freeCache (cache);
+		}
+};
+
+template <int D>
+LatencyResult measure (const LatencyOptions &options, bool useQuery, int depth, int threads)
+{
+	typedef QueryDimension<D> Dim;
+	ModuleGraph *graph = createLayeredGraph(depth);
+	typename Dim::Pipeline pipe;
+	const ElementID id = graph->getRoot()->addToPipeline(&pipe);
+	typename Dim::Query query(&pipe, id);
+
+	std::vector<Worker<D> > workers(threads);
+	for (int i=0;i<threads;++i)
+	{
+		workers[i].pipe = &pipe;
+		workers[i].element = pipe.getElement(id);
+		workers[i].query = useQuery ? &query : NULL;
+		workers[i].count = options.queriesPerThread;
+		workers[i].seed = 1 + i*7919;
+	}
+#if NOISEPP_ENABLE_THREADS
+	if (threads > 1)
+	{
+		StartBarrier barrier;
+		threadpp::ThreadGroup group;
+		for (int i=0;i<threads;++i)
+		{
+			workers[i].barrier = &barrier;
+			group.createThread (Worker<D>::entry, &workers[i]);
+		}
+		barrier.release (threads);
+		group.join ();
+	}
+	else
+#endif
+		workers[0].run ();
+
+	LatencyResult r;
+	r.mode = useQuery ? "query" : "cache";
+	r.dimension = D;
+	r.depth = depth;
+	r.threads = threads;
+	r.histogram.resize (HISTOGRAM_BUCKETS, 0);
+	std::vector<double> all;
+	all.reserve (size_t(threads) * options.queriesPerThread);
+	for (int i=0;i<threads;++i)
+		all.insert (all.end(), workers[i].samples.begin(), workers[i].samples.end());
+	double sum = 0;
+	for (size_t i=0;i<all.size();++i)
+	{
+		sum += all[i];
+		const int bucket = all[i] >= 1.0 ? int(std::log(all[i]) / std::log(2.0)) : 0;
+		r.histogram[std::min(bucket, HISTOGRAM_BUCKETS-1)] += 1;
+	}
+	std::sort (all.begin(), all.end());
+	r.queries = double(all.size());
+	r.mean = all.empty() ? 0 : sum / all.size();
+	r.p50 = Statistics::percentile(all, 50);
+	r.p90 = Statistics::percentile(all, 90);
+	r.p99 = Statistics::percentile(all, 99);
+	r.p999 = Statistics::percentile(all, 99.9);
+	r.max = all.empty() ? 0 : all.back();
+
+	delete graph;
+	return r;
+}
+
+};
+
+double getTimerOverhead ()
+{
+	std::vector<double> samples(10000);
+	for (size_t i=0;i<samples.size();++i)
+	{
+		const double start = Timer::getTime();
+		samples[i] = (Timer::getTime() - start) * 1.0e9;
+	}
+	std::sort (samples.begin(), samples.end());
+	return Statistics::percentile(samples, 50);
+}
+
+void runLatency (const LatencyOptions &options, std::vector<LatencyResult> &results)
+{
+	std::vector<int> threadCounts;
+	threadCounts.push_back (1);
+#if NOISEPP_ENABLE_THREADS
+	if (options.threads > 1)
+		threadCounts.push_back (options.threads);
+#endif
+	const int depths[] = { 1, 4 };
+	for (int mode=0;mode<2;++mode)
+	{
+		for (int dim=2;dim<=3;++dim)
+		{
+			for (int d=0;d<2;++d)
+			{
+				for (size_t t=0;t<threadCounts.size();++t)
+				{
+					std::ostringstream name;
+					name << "latency/" << (mode == 0 ? "query" : "cache") << "/" << dim << "d/d" << depths[d] << "/n" << threadCounts[t];
+					if (!options.filter.empty() && name.str().find(options.filter) == std::string::npos)
+						continue;
+					std::cerr << name.str() << " ... ";
+					std::cerr.flush ();
+					LatencyResult r = (dim == 2) ? measure<2>(options, mode == 0, depths[d], threadCounts[t])
+						: measure<3>(options, mode == 0, depths[d], threadCounts[t]);
+					r.name = name.str();
+					std::cerr << "p50 " << r.p50 << " ns, p99 " << r.p99 << " ns" << std::endl;
+					results.push_back (r);
+				}
+			}
+		}
+	}
+}
+
+void printLatency (std::ostream &out, const std::vector<LatencyResult> &results)
+{
+	out << std::left << std::setw(30) << "case" << std::right
+		<< std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90"
+		<< std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "max" << "  (ns)" << std::endl;
+	out << std::fixed << std::setprecision(0);
+	for (size_t i=0;i<results.size();++i)
+	{
+		const LatencyResult &r = results[i];
+		out << std::left << std::setw(30) << r.name << std::right
+			<< std::setw(10) << r.mean << std::setw(10) << r.p50 << std::setw(10) << r.p90
+			<< std::setw(10) << r.p99 << std::setw(10) << r.p999 << std::setw(12) << r.max << std::endl;
+	}
+}
+
+};
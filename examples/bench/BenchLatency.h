@@ -0,0 +1,54 @@
+#ifndef BENCHLATENCY_H
+#define BENCHLATENCY_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+
+/// Per query latency of single point queries issued from several threads.
+struct LatencyResult
+{
+	std::string name;
+	/// query (PointQuery) or cache (caller managed cache per thread).
+	std::string mode;
+	int dimension;
+	int depth;
+	int threads;
+	/// Number of measured queries over all threads.
+	double queries;
+	/// Latencies in nanoseconds, including the timer overhead.
+	double mean, p50, p90, p99, p999, max;
+	/// Number of queries with a latency in [2^i, 2^(i+1)) nanoseconds.
+	std::vector<double> histogram;
+
+	LatencyResult () : dimension(0), depth(1), threads(1), queries(0), mean(0), p50(0), p90(0), p99(0), p999(0), max(0)
+	{}
+};
+
+/// Selects the latency measurements.
+struct LatencyOptions
+{
+	/// The highest number of querying threads, the counts are 1 and this value.
+	int threads;
+	/// Measured queries per thread.
+	int queriesPerThread;
+	/// Only cases whose name contains this string are measured.
+	std::string filter;
+
+	LatencyOptions () : threads(1), queriesPerThread(100000)
+	{}
+};
+
+/// Measures the latency of every single query.
+void runLatency (const LatencyOptions &options, std::vector<LatencyResult> &results);
+/// Returns the overhead of one timer reading in nanoseconds, it is included in the latencies.
+double getTimerOverhead ();
+/// Prints a table of the latency results.
+void printLatency (std::ostream &out, const std::vector<LatencyResult> &results);
+
+};
+
+#endif // BENCHLATENCY_H
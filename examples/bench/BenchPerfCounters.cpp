@@ -0,0 +1,171 @@
+#include "BenchPerfCounters.h"
+
+#ifdef __linux__
+#	include <cerrno>
+#	include <cstring>
+#	include <unistd.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <linux/perf_event.h>
+#endif
+
+namespace bench
+{
+
+bool CounterValues::isValid () const
+{
+	for (int i=0;i<COUNTER_COUNT;++i)
+	{
+		if (values[i] >= 0)
+			return true;
+	}
+	return false;
+}
+
+double CounterValues::getIPC () const
+{
+	if (values[CYCLES] <= 0 || values[INSTRUCTIONS] < 0)
+		return -1;
+	return values[INSTRUCTIONS] / values[CYCLES];
+}
+
+const char *CounterValues::getName (int counter)
+{
+	switch (counter)
+	{
+		case CYCLES: return "cycles";
+		case INSTRUCTIONS: return "instructions";
+		case L1D_MISSES: return "l1d_misses";
+		case LLC_MISSES: return "llc_misses";
+		case BRANCH_MISSES: return "branch_misses";
+	}
+	return "unknown";
+}
+
+PerfCounters::PerfCounters () : mOpen(false)
+{
+	for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+		mFds[i] = -1;
+}
+
+PerfCounters::~PerfCounters ()
+{
+	close ();
+}
+
+#ifdef __linux__
+
+namespace
+{
+
+int openCounter (__u32 type, __u64 config)
+{
+	struct perf_event_attr attr;
+	memset (&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	// count threads created later on as well, e.g. the workers of a threaded pipeline
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+};
+
+bool PerfCounters::open ()
+{
+	close ();
+	const __u64 l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	mFds[CounterValues::CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	const int err = errno;
+	mFds[CounterValues::INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	mFds[CounterValues::L1D_MISSES] = openCounter(PERF_TYPE_HW_CACHE, l1dReadMiss);
+	mFds[CounterValues::LLC_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	mFds[CounterValues::BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+	{
+		if (mFds[i] >= 0)
+			mOpen = true;
+	}
+	if (!mOpen)
+	{
+		mError = std::string("perf_event_open failed: ") + strerror(err);
+		if (err == EACCES || err == EPERM)
+			mError += " (check /proc/sys/kernel/perf_event_paranoid)";
+	}
+	return mOpen;
+}
+
+void PerfCounters::close ()
+{
+	for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+	{
+		if (mFds[i] >= 0)
+			::close (mFds[i]);
+		mFds[i] = -1;
+	}
+	mOpen = false;
+}
+
+void PerfCounters::start ()
+{
+	for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+	{
+		if (mFds[i] < 0)
+			continue;
+		ioctl (mFds[i], PERF_EVENT_IOC_RESET, 0);
+		ioctl (mFds[i], PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+CounterValues PerfCounters::stop ()
+{
+	CounterValues v;
+	for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+	{
+		if (mFds[i] >= 0)
+			ioctl (mFds[i], PERF_EVENT_IOC_DISABLE, 0);
+	}
+	for (int i=0;i<CounterValues::COUNTER_COUNT;++i)
+	{
+		if (mFds[i] < 0)
+			continue;
+		// value, time enabled, time running
+		__u64 data[3] = { 0, 0, 0 };
+		if (read(mFds[i], data, sizeof(data)) != ssize_t(sizeof(data)) || data[2] == 0)
+			continue;
+		v.values[i] = double(data[0]);
+		if (data[2] < data[1])
+			v.values[i] *= double(data[1]) / double(data[2]);
+	}
+	return v;
+}
+
+#else
+
+bool PerfCounters::open ()
+{
+	mError = "hardware counters are only supported on Linux";
+	return false;
+}
+
+void PerfCounters::close ()
+{
+}
+
+void PerfCounters::start ()
+{
+}
+
+CounterValues PerfCounters::stop ()
+{
+	return CounterValues();
+}
+
+#endif
+
+};
@@ -0,0 +1,70 @@
+#ifndef BENCHPERFCOUNTERS_H
+#define BENCHPERFCOUNTERS_H
+
+#include <string>
+
+namespace bench
+{
+
+/// Hardware counter values, totals of a measured region.
+struct CounterValues
+{
+	enum Counter { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, COUNTER_COUNT };
+
+	/// The counter values, negative if the counter is not available.
+	double values[COUNTER_COUNT];
+
+	CounterValues ()
+	{
+		for (int i=0;i<COUNTER_COUNT;++i)
+			values[i] = -1;
+	}
+	/// Returns whether at least one counter was read.
+	bool isValid () const;
+	/// Returns instructions per cycle or a negative value if not available.
+	double getIPC () const;
+	/// Returns the JSON key of the counter.
+	static const char *getName (int counter);
+};
+
+/// Reads hardware performance counters of the calling process and its threads.
+/// Uses perf_event_open on Linux and is not available on other platforms.
+/// The counters must be opened before the worker threads are created, since only threads created
+/// after opening inherit them.
+class PerfCounters
+{
+	private:
+		int mFds[CounterValues::COUNTER_COUNT];
+		bool mOpen;
+		std::string mError;
+
+		PerfCounters (const PerfCounters &);
+		PerfCounters &operator= (const PerfCounters &);
+
+	public:
+		PerfCounters ();
+		~PerfCounters ();
+		/// Opens the counters, returns false if none of them is available.
+		bool open ();
+		/// Closes the counters.
+		void close ();
+		/// Returns whether the counters are open.
+		bool isOpen () const
+		{
+			return mOpen;
+		}
+		/// Returns why open() failed.
+		const std::string &getError () const
+		{
+			return mError;
+		}
+		/// Resets and starts counting.
+		void start ();
+		/// Stops counting and returns the values since start().
+		/// Values are scaled if the kernel had to multiplex the counters.
+		CounterValues stop ();
+};
+
+};
+
+#endif // BENCHPERFCOUNTERS_H
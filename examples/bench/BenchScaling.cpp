@@ -0,0 +1,304 @@
+#include "BenchScaling.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "Noise.h"
+#include "NoiseUtils.h"
+
+#include "BenchSuite.h"
+
+namespace bench
+{
+
+using namespace noisepp;
+using namespace noisepp::utils;
+
+#if NOISEPP_ENABLE_THREADS
+
+namespace
+{
+
+/// Bounds of a tile, bigger tiles sample the same area more densely.
+const Real TILE_EXTENT = 4.0;
+
+void setupGradient (GradientRenderer &renderer)
+{
+	renderer.addGradient (-1.0, ColourValue(0.0f, 0.0f, 0.5f));
+	renderer.addGradient (0.0, ColourValue(0.0f, 0.5f, 1.0f));
+	renderer.addGradient (0.1, ColourValue(0.9f, 0.9f, 0.3f));
+	renderer.addGradient (0.4, ColourValue(0.1f, 0.6f, 0.0f));
+	renderer.addGradient (1.0, ColourValue(1.0f, 1.0f, 1.0f));
+}
+
+/// A case whose jobs can be recorded by a tracer.
+class ScalingCase : public Case
+{
+	public:
+		/// Executes one run with the tracer attached, between setup() and teardown().
+		virtual void runTraced (JobTracer &tracer) = 0;
+};
+
+/// Builds a tile with PlaneBuilder2D on a threaded pipeline, optionally rendering it with a gradient.
+class PlaneCase : public ScalingCase
+{
+	private:
+		ModuleGraph *mGraph;
+		int mSize;
+		bool mRender;
+		ThreadedPipeline2D *mPipe;
+		PipelineElement2D *mElement;
+		std::vector<Real> mData;
+		Image mImage;
+		GradientRenderer mRenderer;
+		PlaneBuilder2D mBuilder;
+
+	public:
+		PlaneCase (ModuleGraph *graph, int size, bool render) : mGraph(graph), mSize(size), mRender(render), mPipe(NULL), mElement(NULL)
+		{
+			setupGradient (mRenderer);
+		}
+		~PlaneCase ()
+		{
+			delete mGraph;
+		}
+		void setup ()
+		{
+			mPipe = new ThreadedPipeline2D(threads);
+			mElement = mPipe->getElement(mGraph->getRoot()->addToPipeline(mPipe));
+			mData.resize (mSize*mSize);
+			mBuilder.setSize (mSize, mSize);
+			mBuilder.setBounds (0, 0, TILE_EXTENT, TILE_EXTENT);
+			mBuilder.setDestination (&mData[0]);
+			if (mRender)
+			{
+				mImage.create (mSize, mSize);
+				mBuilder.setImageDestination (&mImage, &mRenderer);
+			}
+		}
+		void run ()
+		{
+			mBuilder.build (mPipe, mElement);
+		}
+		void runTraced (JobTracer &tracer)
+		{
+			mPipe->setTracer (&tracer);
+			run ();
+			mPipe->setTracer (NULL);
+		}
+		void teardown ()
+		{
+			delete mPipe;
+			mPipe = NULL;
+		}
+		size_t getSampleCount () const
+		{
+			return mSize*mSize;
+		}
+		double getChecksum () const
+		{
+			double sum = 0;
+			for (size_t i=0;i<mData.size();++i)
+				sum += mData[i];
+			return sum;
+		}
+};
+
+/// Renders prebuilt tile data with GradientRenderer::renderImage().
+/// The renderer deletes the job queue after each call, so the thread start-up is part of the measurement.
+class GradientCase : public ScalingCase
+{
+	private:
+		ModuleGraph *mGraph;
+		int mSize;
+		std::vector<Real> mData;
+		Image mImage;
+		GradientRenderer mRenderer;
+
+	public:
+		GradientCase (ModuleGraph *graph, int size) : mGraph(graph), mSize(size)
+		{
+			setupGradient (mRenderer);
+		}
+		~GradientCase ()
+		{
+			delete mGraph;
+		}
+		void setup ()
+		{
+			mData.resize (mSize*mSize);
+			PlaneBuilder2D builder;
+			builder.setModule (mGraph->getRoot());
+			builder.setSize (mSize, mSize);
+			builder.setBounds (0, 0, TILE_EXTENT, TILE_EXTENT);
+			builder.setDestination (&mData[0]);
+			builder.build ();
+			mImage.create (mSize, mSize);
+		}
+		void run ()
+		{
+			mRenderer.renderImage (mImage, &mData[0], new ThreadedJobQueue(threads));
+		}
+		void runTraced (JobTracer &tracer)
+		{
+			ThreadedJobQueue *queue = new ThreadedJobQueue(threads);
+			queue->setTracer (&tracer);
+			mRenderer.renderImage (mImage, &mData[0], queue);
+		}
+		size_t getSampleCount () const
+		{
+			return mSize*mSize;
+		}
+};
+
+/// Fills utilization and wait times from the events of one traced run.
+void analyzeTrace (const JobTracer &tracer, double wallTime, ScalingResult &r)
+{
+	std::vector<JobTracer::Event> events;
+	for (size_t t=0;t<tracer.getThreadCount();++t)
+	{
+		const JobTracer::ThreadBuffer *buffer = tracer.getThread(t);
+		buffer->getEvents (events);
+		double busy = 0, gaps = 0, wait = 0;
+		double executeBegin = -1, lastEnd = -1, waitBegin = -1;
+		for (size_t i=0;i<events.size();++i)
+		{
+			const JobTracer::Event &e = events[i];
+			switch (e.type)
+			{
+				case JobTracer::EVENT_EXECUTE_BEGIN:
+					executeBegin = e.time;
+					if (lastEnd >= 0)
+						gaps += e.time - lastEnd;
+					break;
+				case JobTracer::EVENT_EXECUTE_END:
+					if (executeBegin >= 0)
+						busy += e.time - executeBegin;
+					executeBegin = -1;
+					lastEnd = e.time;
+					break;
+				case JobTracer::EVENT_WAIT_BEGIN:
+					waitBegin = e.time;
+					break;
+				case JobTracer::EVENT_WAIT_END:
+					if (waitBegin >= 0)
+						wait += e.time - waitBegin;
+					waitBegin = -1;
+					break;
+				default:
+					break;
+			}
+		}
+		if (buffer->getName() == "main")
+			r.mainWait += wait;
+		else
+		{
+			r.lockWait += gaps;
+			r.utilization.push_back (wallTime > 0 ? busy / wallTime : 0);
+		}
+	}
+	// workers that never got a job did not register with the tracer
+	while (int(r.utilization.size()) < r.timing.threads)
+		r.utilization.push_back (0);
+	std::sort (r.utilization.begin(), r.utilization.end());
+	std::reverse (r.utilization.begin(), r.utilization.end());
+}
+
+};
+
+void runScaling (const ScalingOptions &options, Harness &harness, std::vector<ScalingResult> &results)
+{
+	std::vector<int> threadCounts;
+	for (int n=1;n<options.maxThreads;n*=2)
+		threadCounts.push_back (n);
+	threadCounts.push_back (std::max(options.maxThreads, 1));
+
+	const char *workloads[] = { "plane", "plane+gradient", "gradient" };
+	const int tileSizes[] = { 64, 128, 256, 512 };
+	const int depths[] = { 1, 4, 16 };
+	for (int w=0;w<3;++w)
+	{
+		for (int s=0;s<4;++s)
+		{
+			for (int d=0;d<3;++d)
+			{
+				double singleThreadTime = 0;
+				for (size_t t=0;t<threadCounts.size();++t)
+				{
+					std::ostringstream name;
+					name << "scaling/" << workloads[w] << "/t" << tileSizes[s] << "/d" << depths[d] << "/n" << threadCounts[t];
+					if (!options.filter.empty() && name.str().find(options.filter) == std::string::npos)
+						continue;
+
+					ScalingCase *c;
+					if (w == 2)
+						c = new GradientCase(createLayeredGraph(depths[d]), tileSizes[s]);
+					else
+						c = new PlaneCase(createLayeredGraph(depths[d]), tileSizes[s], w == 1);
+					c->name = name.str();
+					c->dimension = 2;
+					c->path = workloads[w];
+					c->module = "layered";
+					c->depth = depths[d];
+					c->threads = threadCounts[t];
+
+					ScalingResult r;
+					r.workload = workloads[w];
+					r.tileSize = tileSizes[s];
+					r.timing = harness.measure(*c);
+
+					// the traced run is separate so the tracing cost does not show up in the timing
+					JobTracer tracer;
+					c->setup ();
+					const double start = Timer::getTime();
+					c->runTraced (tracer);
+					const double wallTime = Timer::getTime() - start;
+					analyzeTrace (tracer, wallTime, r);
+					c->teardown ();
+					delete c;
+
+					if (threadCounts[t] == 1)
+						singleThreadTime = r.timing.time.median;
+					if (singleThreadTime > 0 && r.timing.time.median > 0)
+					{
+						r.speedup = singleThreadTime / r.timing.time.median;
+						r.efficiency = r.speedup / threadCounts[t];
+					}
+					results.push_back (r);
+				}
+			}
+		}
+	}
+}
+
+#else
+
+void runScaling (const ScalingOptions &options, Harness &harness, std::vector<ScalingResult> &results)
+{
+	std::cerr << "Thread scaling needs NOISEPP_ENABLE_THREADS" << std::endl;
+}
+
+#endif
+
+void printScaling (std::ostream &out, const std::vector<ScalingResult> &results)
+{
+	out << std::left << std::setw(36) << "case" << std::right
+		<< std::setw(10) << "Msamp/s" << std::setw(9) << "speedup" << std::setw(8) << "eff"
+		<< std::setw(12) << "lock ms" << std::setw(12) << "wait ms" << "  utilization" << std::endl;
+	out << std::fixed;
+	for (size_t i=0;i<results.size();++i)
+	{
+		const ScalingResult &r = results[i];
+		out << std::left << std::setw(36) << r.timing.name << std::right << std::setprecision(2)
+			<< std::setw(10) << r.timing.throughput << std::setw(9) << r.speedup << std::setw(8) << r.efficiency
+			<< std::setprecision(3) << std::setw(12) << r.lockWait*1.0e3 << std::setw(12) << r.mainWait*1.0e3 << " ";
+		out << std::setprecision(0);
+		for (size_t t=0;t<r.utilization.size();++t)
+			out << " " << r.utilization[t]*100.0 << "%";
+		out << std::endl;
+	}
+}
+
+};
@@ -0,0 +1,58 @@
+#ifndef BENCHSCALING_H
+#define BENCHSCALING_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+
+namespace bench
+{
+
+/// Result of one thread scaling measurement.
+struct ScalingResult
+{
+	/// Timing of the workload.
+	Result timing;
+	/// Workload name (plane, plane+gradient or gradient).
+	std::string workload;
+	/// Tile width and height in pixels.
+	int tileSize;
+	/// Speedup relative to the single thread run.
+	double speedup;
+	/// Speedup divided by the number of threads.
+	double efficiency;
+	/// Seconds per run the workers spent between finishing a job and starting the next one,
+	/// summed over all workers. This is the mutex hand-off and queue pop cost.
+	double lockWait;
+	/// Seconds per run the main thread waited for finished jobs.
+	double mainWait;
+	/// Fraction of the run time each worker spent executing jobs.
+	std::vector<double> utilization;
+
+	ScalingResult () : tileSize(0), speedup(0), efficiency(0), lockWait(0), mainWait(0)
+	{}
+};
+
+/// Selects the scaling measurements.
+struct ScalingOptions
+{
+	/// The highest thread count, the counts are 1, 2, 4 ... up to this value.
+	int maxThreads;
+	/// Only workloads whose name contains this string are measured.
+	std::string filter;
+
+	ScalingOptions () : maxThreads(1)
+	{}
+};
+
+/// Runs PlaneBuilder2D and GradientRenderer workloads at increasing thread counts.
+/// The timing comes from the harness, utilization and wait times from an extra traced run.
+void runScaling (const ScalingOptions &options, Harness &harness, std::vector<ScalingResult> &results);
+/// Prints a table of the scaling results.
+void printScaling (std::ostream &out, const std::vector<ScalingResult> &results);
+
+};
+
+#endif // BENCHSCALING_H
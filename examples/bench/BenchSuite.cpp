@@ -0,0 +1,593 @@
+#include "BenchSuite.h"
+
+#include <sstream>
+
+namespace bench
+{
+
+using namespace noisepp;
+
+namespace
+{
+
+/// All cases sample the area [0, EXTENT) along each axis.
+const Real EXTENT = 8.0;
+/// Samples per run of the point and line paths.
+const int LINE_SAMPLES = 4096;
+/// Grid size of the 2D grid path.
+const int GRID2D_SIZE = 128;
+/// Grid size of the 3D grid path.
+const int GRID3D_SIZE = 32;
+const int GRID3D_DEPTH = 16;
+
+template <int D>
+struct Dimension;
+
+template <>
+struct Dimension<1>
+{
+	typedef Pipeline1D Pipeline;
+	typedef PipelineElement1D Element;
+#if NOISEPP_ENABLE_THREADS
+	typedef ThreadedPipeline1D ThreadedPipeline;
+#endif
+	static Real getValue (Element *e, const Real *p, Cache *cache)
+	{
+		return e->getValue (p[0], cache);
+	}
+	static void executeLine (Pipeline *pipe, Element *e, const Real *p, int n, Real xDelta, Real *buffer, Cache *cache)
+	{
+		LineJob1D job(pipe, e, p[0], n, xDelta, buffer);
+		job.execute (cache);
+	}
+	static PipelineJob *createLineJob (Pipeline *pipe, Element *e, const Real *p, int n, Real xDelta, Real *buffer)
+	{
+		return new LineJob1D(pipe, e, p[0], n, xDelta, buffer);
+	}
+};
+
+template <>
+struct Dimension<2>
+{
+	typedef Pipeline2D Pipeline;
+	typedef PipelineElement2D Element;
+#if NOISEPP_ENABLE_THREADS
+	typedef ThreadedPipeline2D ThreadedPipeline;
+#endif
+	static Real getValue (Element *e, const Real *p, Cache *cache)
+	{
+		return e->getValue (p[0], p[1], cache);
+	}
+	static void executeLine (Pipeline *pipe, Element *e, const Real *p, int n, Real xDelta, Real *buffer, Cache *cache)
+	{
+		LineJob2D job(pipe, e, p[0], p[1], n, xDelta, buffer);
+		job.execute (cache);
+	}
+	static PipelineJob *createLineJob (Pipeline *pipe, Element *e, const Real *p, int n, Real xDelta, Real *buffer)
+	{
+		return new LineJob2D(pipe, e, p[0], p[1], n, xDelta, buffer);
+	}
+};
+
+template <>
+struct Dimension<3>
+{
+	typedef Pipeline3D Pipeline;
+	typedef PipelineElement3D Element;
+#if NOISEPP_ENABLE_THREADS
+	typedef ThreadedPipeline3D ThreadedPipeline;
+#endif
+	static Real getValue (Element *e, const Real *p, Cache *cache)
+	{
+		return e->getValue (p[0], p[1], p[2], cache);
+	}
+	static void executeLine (Pipeline *pipe, Element *e, const Real *p, int n, Real xDelta, Real *buffer, Cache *cache)
+	{
+		LineJob3D job(pipe, e, p[0], p[1], p[2], n, xDelta, buffer);
+		job.execute (cache);
+	}
+	static PipelineJob *createLineJob (Pipeline *pipe, Element *e, const Real *p, int n, Real xDelta, Real *buffer)
+	{
+		return new LineJob3D(pipe, e, p[0], p[1], p[2], n, xDelta, buffer);
+	}
+};
+
+/// Base class of the cases evaluating a module graph.
+class GraphCase : public Case
+{
+	protected:
+		ModuleGraph *mGraph;
+		std::vector<Real> mBuffer;
+
+	public:
+		GraphCase (ModuleGraph *graph) : mGraph(graph)
+		{}
+		~GraphCase ()
+		{
+			delete mGraph;
+		}
+		double getChecksum () const
+		{
+			double sum = 0;
+			for (size_t i=0;i<mBuffer.size();++i)
+				sum += mBuffer[i];
+			return sum;
+		}
+};
+
+/// Evaluates single points at scattered coordinates, cleaning the cache before each one.
+template <int D>
+class PointCase : public GraphCase
+{
+	private:
+		typedef Dimension<D> Dim;
+		typename Dim::Pipeline *mPipe;
+		typename Dim::Element *mElement;
+		Cache *mCache;
+		std::vector<Real> mCoords;
+
+	public:
+		PointCase (ModuleGraph *graph) : GraphCase(graph), mPipe(NULL), mElement(NULL), mCache(NULL)
+		{}
+		void setup ()
+		{
+			mPipe = new typename Dim::Pipeline;
+			mElement = mPipe->getElement(mGraph->getRoot()->addToPipeline(mPipe));
+			mCache = mPipe->createCache();
+			// scattered but reproducible coordinates
+			unsigned state = 12345;
+			mCoords.resize (LINE_SAMPLES*D);
+			for (size_t i=0;i<mCoords.size();++i)
+			{
+				state = state * 1664525u + 1013904223u;
+				mCoords[i] = Real(state >> 8) / Real(1 << 24) * EXTENT;
+			}
+			mBuffer.resize (LINE_SAMPLES);
+		}
+		void run ()
+		{
+			const Real *p = &mCoords[0];
+			for (int i=0;i<LINE_SAMPLES;++i,p+=D)
+			{
+				mPipe->cleanCache (mCache);
+				mBuffer[i] = Dim::getValue(mElement, p, mCache);
+			}
+		}
+		void teardown ()
+		{
+			mPipe->freeCache (mCache);
+			delete mPipe;
+			mPipe = NULL;
+		}
+		size_t getSampleCount () const
+		{
+			return LINE_SAMPLES;
+		}
+};
+
+/// Evaluates a line along the x-axis with a single line job.
+template <int D>
+class LineCase : public GraphCase
+{
+	private:
+		typedef Dimension<D> Dim;
+		typename Dim::Pipeline *mPipe;
+		typename Dim::Element *mElement;
+		Cache *mCache;
+
+	public:
+		LineCase (ModuleGraph *graph) : GraphCase(graph), mPipe(NULL), mElement(NULL), mCache(NULL)
+		{}
+		void setup ()
+		{
+			mPipe = new typename Dim::Pipeline;
+			mElement = mPipe->getElement(mGraph->getRoot()->addToPipeline(mPipe));
+			mCache = mPipe->createCache();
+			mBuffer.resize (LINE_SAMPLES);
+		}
+		void run ()
+		{
+			const Real start[3] = { 0, Real(1.37), Real(2.71) };
+			Dim::executeLine (mPipe, mElement, start, LINE_SAMPLES, EXTENT/LINE_SAMPLES, &mBuffer[0], mCache);
+		}
+		void teardown ()
+		{
+			mPipe->freeCache (mCache);
+			delete mPipe;
+			mPipe = NULL;
+		}
+		size_t getSampleCount () const
+		{
+			return LINE_SAMPLES;
+		}
+};
+
+/// Evaluates a 2D or 3D grid as line jobs through executeJobs(), optionally threaded.
+template <int D, class Pipeline>
+class GridCase : public GraphCase
+{
+	private:
+		typedef Dimension<D> Dim;
+		Pipeline *mPipe;
+		typename Dim::Element *mElement;
+		int mWidth, mHeight, mDepth;
+
+	public:
+		GridCase (ModuleGraph *graph) : GraphCase(graph), mPipe(NULL), mElement(NULL)
+		{
+			mWidth = mHeight = (D == 3) ? GRID3D_SIZE : GRID2D_SIZE;
+			mDepth = (D == 3) ? GRID3D_DEPTH : 1;
+		}
+		void setup ()
+		{
+			mPipe = createPipeline();
+			mElement = mPipe->getElement(mGraph->getRoot()->addToPipeline(mPipe));
+			mBuffer.resize (mWidth*mHeight*mDepth);
+		}
+		void run ()
+		{
+			Real *buffer = &mBuffer[0];
+			Real p[3] = { 0, 0, 0 };
+			for (int z=0;z<mDepth;++z)
+			{
+				p[2] = EXTENT * z / mDepth;
+				for (int y=0;y<mHeight;++y)
+				{
+					p[1] = EXTENT * y / mHeight;
+					mPipe->addJob (Dim::createLineJob(mPipe, mElement, p, mWidth, EXTENT/mWidth, buffer));
+					buffer += mWidth;
+				}
+			}
+			mPipe->executeJobs ();
+		}
+		void teardown ()
+		{
+			delete mPipe;
+			mPipe = NULL;
+		}
+		size_t getSampleCount () const
+		{
+			return mBuffer.size();
+		}
+		/// Creates the pipeline, overridden by the threaded case.
+		virtual Pipeline *createPipeline ()
+		{
+			return new Pipeline;
+		}
+};
+
+#if NOISEPP_ENABLE_THREADS
+/// Evaluates the grid with a threaded pipeline.
+template <int D>
+class ThreadedGridCase : public GridCase<D, typename Dimension<D>::Pipeline>
+{
+	public:
+		ThreadedGridCase (ModuleGraph *graph) : GridCase<D, typename Dimension<D>::Pipeline>(graph)
+		{}
+		typename Dimension<D>::Pipeline *createPipeline ()
+		{
+			return new typename Dimension<D>::ThreadedPipeline(this->threads);
+		}
+};
+#endif
+
+/// Perlin source with few octaves so the cost of the module under test stays visible.
+PerlinModule *createSource (ModuleGraph *graph, int seed)
+{
+	PerlinModule *m = graph->create<PerlinModule>();
+	m->setSeed (seed);
+	m->setOctaveCount (2);
+	return m;
+}
+
+template <int D>
+void addCases (const SuiteOptions &options, const std::string &suffix, ModuleTypeId type, int quality, int depth, std::vector<Case*> &cases)
+{
+	std::ostringstream dim;
+	dim << D << "d/";
+	const char *paths[] = { "point", "line", "grid", "threaded" };
+	for (int i=0;i<4;++i)
+	{
+		const std::string path = paths[i];
+		// a 1D grid is just a line
+		if (D == 1 && i >= 2)
+			continue;
+#if NOISEPP_ENABLE_THREADS
+		if (i == 3 && options.threads < 2)
+			continue;
+#else
+		if (i == 3)
+			continue;
+#endif
+		const std::string name = dim.str() + path + "/" + suffix;
+		if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+			continue;
+
+		ModuleGraph *graph = depth > 0 ? createLayeredGraph(depth) : createModuleGraph(type, quality);
+		Case *c = NULL;
+		if (i == 0)
+			c = new PointCase<D>(graph);
+		else if (i == 1)
+			c = new LineCase<D>(graph);
+		else if (i == 2)
+			c = new GridCase<D, typename Dimension<D>::Pipeline>(graph);
+#if NOISEPP_ENABLE_THREADS
+		else
+			c = new ThreadedGridCase<D>(graph);
+#endif
+		c->name = name;
+		c->dimension = D;
+		c->path = path;
+		c->module = depth > 0 ? "layered" : getModuleName(type);
+		c->quality = quality;
+		c->depth = depth > 0 ? depth : 1;
+		c->threads = (i == 3) ? options.threads : 1;
+		cases.push_back (c);
+	}
+}
+
+void addCases (const SuiteOptions &options, const std::string &suffix, ModuleTypeId type, int quality, int depth, std::vector<Case*> &cases)
+{
+	addCases<1> (options, suffix, type, quality, depth, cases);
+	addCases<2> (options, suffix, type, quality, depth, cases);
+	addCases<3> (options, suffix, type, quality, depth, cases);
+}
+
+};
+
+ModuleGraph::~ModuleGraph ()
+{
+	for (size_t i=0;i<mModules.size();++i)
+		delete mModules[i];
+}
+
+const char *getModuleName (ModuleTypeId type)
+{
+	switch (type)
+	{
+		case MODULE_PERLIN: return "perlin";
+		case MODULE_BILLOW: return "billow";
+		case MODULE_ADDITION: return "addition";
+		case MODULE_ABSOLUTE: return "absolute";
+		case MODULE_BLEND: return "blend";
+		case MODULE_CHECKERBOARD: return "checkerboard";
+		case MODULE_CLAMP: return "clamp";
+		case MODULE_CONSTANT: return "constant";
+		case MODULE_CURVE: return "curve";
+		case MODULE_EXPONENT: return "exponent";
+		case MODULE_INVERT: return "invert";
+		case MODULE_MAXIMUM: return "maximum";
+		case MODULE_MINIMUM: return "minimum";
+		case MODULE_MULTIPLY: return "multiply";
+		case MODULE_POWER: return "power";
+		case MODULE_RIDGEDMULTI: return "ridgedmulti";
+		case MODULE_SCALEBIAS: return "scalebias";
+		case MODULE_SELECT: return "select";
+		case MODULE_SCALEPOINT: return "scalepoint";
+		case MODULE_TURBULENCE: return "turbulence";
+		case MODULE_TERRACE: return "terrace";
+		case MODULE_TRANSLATEPOINT: return "translatepoint";
+		case MODULE_VORONOI: return "voronoi";
+		case MODULE_BAKEDGRID: return "bakedgrid";
+	}
+	return "unknown";
+}
+
+bool hasQuality (ModuleTypeId type)
+{
+	return type == MODULE_PERLIN || type == MODULE_BILLOW || type == MODULE_RIDGEDMULTI || type == MODULE_TURBULENCE;
+}
+
+ModuleGraph *createModuleGraph (ModuleTypeId type, int quality)
+{
+	ModuleGraph *graph = new ModuleGraph;
+	Module *root = NULL;
+	switch (type)
+	{
+		case MODULE_PERLIN:
+		{
+			PerlinModule *m = graph->create<PerlinModule>();
+			m->setQuality (quality);
+			root = m;
+			break;
+		}
+		case MODULE_BILLOW:
+		{
+			BillowModule *m = graph->create<BillowModule>();
+			m->setQuality (quality);
+			root = m;
+			break;
+		}
+		case MODULE_RIDGEDMULTI:
+		{
+			RidgedMultiModule *m = graph->create<RidgedMultiModule>();
+			m->setQuality (quality);
+			root = m;
+			break;
+		}
+		case MODULE_TURBULENCE:
+		{
+			TurbulenceModule *m = graph->create<TurbulenceModule>();
+			m->setQuality (quality);
+			m->setSourceModule (0, createSource(graph, 0));
+			root = m;
+			break;
+		}
+		case MODULE_VORONOI:
+		{
+			VoronoiModule *m = graph->create<VoronoiModule>();
+			m->setEnableDistance (true);
+			root = m;
+			break;
+		}
+		case MODULE_CHECKERBOARD:
+			root = graph->create<CheckerboardModule>();
+			break;
+		case MODULE_CONSTANT:
+			root = graph->create<ConstantModule>();
+			break;
+		case MODULE_ABSOLUTE:
+			root = graph->create<AbsoluteModule>();
+			break;
+		case MODULE_CLAMP:
+		{
+			ClampModule *m = graph->create<ClampModule>();
+			m->setLowerBound (-0.5);
+			m->setUpperBound (0.5);
+			root = m;
+			break;
+		}
+		case MODULE_CURVE:
+		{
+			CurveModule *m = graph->create<CurveModule>();
+			m->addControlPoint (-1.0, -1.0);
+			m->addControlPoint (-0.5, -0.2);
+			m->addControlPoint (0.0, 0.1);
+			m->addControlPoint (0.5, 0.6);
+			m->addControlPoint (1.0, 1.0);
+			root = m;
+			break;
+		}
+		case MODULE_EXPONENT:
+			root = graph->create<ExponentModule>();
+			break;
+		case MODULE_INVERT:
+			root = graph->create<InvertModule>();
+			break;
+		case MODULE_SCALEBIAS:
+		{
+			ScaleBiasModule *m = graph->create<ScaleBiasModule>();
+			m->setScale (0.5);
+			m->setBias (0.25);
+			root = m;
+			break;
+		}
+		case MODULE_TERRACE:
+		{
+			TerraceModule *m = graph->create<TerraceModule>();
+			m->addControlPoint (-1.0);
+			m->addControlPoint (-0.25);
+			m->addControlPoint (0.25);
+			m->addControlPoint (1.0);
+			root = m;
+			break;
+		}
+		case MODULE_SCALEPOINT:
+		{
+			ScalePointModule *m = graph->create<ScalePointModule>();
+			m->setScaleX (2.0);
+			m->setScaleY (2.0);
+			m->setScaleZ (2.0);
+			root = m;
+			break;
+		}
+		case MODULE_TRANSLATEPOINT:
+		{
+			TranslatePointModule *m = graph->create<TranslatePointModule>();
+			m->setTranslationX (0.5);
+			m->setTranslationY (0.5);
+			m->setTranslationZ (0.5);
+			root = m;
+			break;
+		}
+		case MODULE_BAKEDGRID:
+		{
+			BakedGridModule *m = graph->create<BakedGridModule>();
+			m->setBounds (0, 0, 0, EXTENT, EXTENT, EXTENT);
+			m->setResolution (64, 64, 64);
+			root = m;
+			break;
+		}
+		case MODULE_ADDITION:
+			root = graph->create<AdditionModule>();
+			break;
+		case MODULE_MAXIMUM:
+			root = graph->create<MaximumModule>();
+			break;
+		case MODULE_MINIMUM:
+			root = graph->create<MinimumModule>();
+			break;
+		case MODULE_MULTIPLY:
+			root = graph->create<MultiplyModule>();
+			break;
+		case MODULE_POWER:
+		{
+			PowerModule *m = graph->create<PowerModule>();
+			ConstantModule *exponent = graph->create<ConstantModule>();
+			exponent->setValue (2.0);
+			m->setSourceModule (0, createSource(graph, 0));
+			m->setSourceModule (1, exponent);
+			root = m;
+			break;
+		}
+		case MODULE_BLEND:
+			root = graph->create<BlendModule>();
+			break;
+		case MODULE_SELECT:
+		{
+			SelectModule *m = graph->create<SelectModule>();
+			m->setLowerBound (-0.2);
+			m->setUpperBound (0.4);
+			m->setEdgeFalloff (0.1);
+			root = m;
+			break;
+		}
+	}
+	// connect the remaining sources to cheap Perlin modules
+	for (size_t i=0;i<root->getSourceModuleCount();++i)
+	{
+		if (!root->getSourceModule(i))
+			root->setSourceModule (i, createSource(graph, int(i)+1));
+	}
+	graph->setRoot (root);
+	return graph;
+}
+
+ModuleGraph *createLayeredGraph (int depth)
+{
+	// every layer adds a detail octave to the previous result, like a typical terrain graph
+	ModuleGraph *graph = new ModuleGraph;
+	Module *root = createSource(graph, 0);
+	for (int i=1;i<depth;++i)
+	{
+		PerlinModule *detail = createSource(graph, i);
+		detail->setFrequency (Real(1 << (i % 8)));
+		AdditionModule *add = graph->create<AdditionModule>();
+		add->setSourceModule (0, root);
+		add->setSourceModule (1, detail);
+		ScaleBiasModule *scale = graph->create<ScaleBiasModule>();
+		scale->setSourceModule (0, add);
+		scale->setScale (0.5);
+		root = scale;
+	}
+	graph->setRoot (root);
+	return graph;
+}
+
+void createSuite (const SuiteOptions &options, std::vector<Case*> &cases)
+{
+	for (int type=MODULE_PERLIN;type<=MODULE_BAKEDGRID;++type)
+	{
+		const ModuleTypeId id = ModuleTypeId(type);
+		if (hasQuality(id))
+		{
+			for (int q=NOISE_QUALITY_LOW;q<=NOISE_QUALITY_FAST_HIGH;++q)
+			{
+				std::ostringstream suffix;
+				suffix << getModuleName(id) << ".q" << q;
+				addCases (options, suffix.str(), id, q, 0, cases);
+			}
+		}
+		else
+			addCases (options, getModuleName(id), id, -1, 0, cases);
+	}
+	const int depths[] = { 1, 2, 4, 8, 16 };
+	for (int i=0;i<5;++i)
+	{
+		std::ostringstream suffix;
+		suffix << "layered.d" << depths[i];
+		addCases (options, suffix.str(), MODULE_PERLIN, -1, depths[i], cases);
+	}
+}
+
+};
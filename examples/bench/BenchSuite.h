@@ -0,0 +1,73 @@
+#ifndef BENCHSUITE_H
+#define BENCHSUITE_H
+
+#include <string>
+#include <vector>
+
+#include "Noise.h"
+#include "BenchHarness.h"
+
+namespace bench
+{
+
+/// Owns the modules of a benchmark graph.
+class ModuleGraph
+{
+	private:
+		std::vector<noisepp::Module*> mModules;
+		noisepp::Module *mRoot;
+
+		ModuleGraph (const ModuleGraph &);
+		ModuleGraph &operator= (const ModuleGraph &);
+
+	public:
+		ModuleGraph () : mRoot(NULL)
+		{}
+		~ModuleGraph ();
+		/// Creates a module owned by the graph.
+		template <class T>
+		T *create ()
+		{
+			T *m = new T;
+			mModules.push_back (m);
+			return m;
+		}
+		/// Sets the module the pipelines are built from.
+		void setRoot (noisepp::Module *root)
+		{
+			mRoot = root;
+		}
+		/// Returns the module the pipelines are built from.
+		noisepp::Module *getRoot () const
+		{
+			return mRoot;
+		}
+};
+
+/// Returns a short lower case name of the module type.
+const char *getModuleName (noisepp::ModuleTypeId type);
+/// Returns whether the module type has a noise quality setting.
+bool hasQuality (noisepp::ModuleTypeId type);
+/// Creates a graph with the module type under test on top of cheap Perlin sources.
+ModuleGraph *createModuleGraph (noisepp::ModuleTypeId type, int quality);
+/// Creates a layered terrain-like graph with the specified number of layers.
+ModuleGraph *createLayeredGraph (int depth);
+
+/// Selects the cases of the suite.
+struct SuiteOptions
+{
+	/// Only cases whose name contains this string are created.
+	std::string filter;
+	/// Number of threads used by the threaded path.
+	int threads;
+
+	SuiteOptions () : threads(1)
+	{}
+};
+
+/// Appends all cases of the suite to the list, the caller deletes them.
+void createSuite (const SuiteOptions &options, std::vector<Case*> &cases);
+
+};
+
+#endif // BENCHSUITE_H
@@ -0,0 +1,243 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+#include "Noise.h"
+#include "NoiseUtils.h"
+
+#include "BenchHarness.h"
+#include "BenchJson.h"
+#include "BenchLatency.h"
+#include "BenchScaling.h"
+#include "BenchSuite.h"
+
+using namespace std;
+
+void printUsage ()
+{
+	cerr << "Usage: bench [options]" << endl;
+	cerr << "       bench --compare <baseline.json> <current.json> [--threshold <percent>]" << endl;
+	cerr << endl;
+	cerr << "Options:" << endl;
+	cerr << "  --filter <text>      only run cases whose name contains the text" << endl;
+	cerr << "  --output <file>      write the JSON results to the file (default: bench.json, - for stdout)" << endl;
+	cerr << "  --repetitions <n>    measured repetitions per case (default: 15)" << endl;
+	cerr << "  --warmup <seconds>   minimum warm-up time per case (default: 0.1)" << endl;
+	cerr << "  --threads <n>        threads used by the threaded path (default: number of CPUs)" << endl;
+	cerr << "  --counters           read hardware performance counters (Linux perf_event_open)" << endl;
+	cerr << "  --scaling            run the thread scaling workloads instead of the module suite" << endl;
+	cerr << "  --max-threads <n>    highest thread count of the scaling runs (default: number of CPUs)" << endl;
+	cerr << "  --latency            measure the latency of single point queries instead of the module suite" << endl;
+	cerr << "  --queries <n>        measured queries per thread in latency mode (default: 100000)" << endl;
+	cerr << "  --quick              fewer repetitions and shorter warm-up, for smoke testing" << endl;
+	cerr << "  --list               list the case names and exit" << endl;
+}
+
+/// Compares two result files, returns the number of regressions.
+int compare (const string &baselineFile, const string &currentFile, double threshold)
+{
+	vector<bench::Result> baseline, current;
+	string error;
+	if (!bench::readResults(baselineFile, baseline, error) || !bench::readResults(currentFile, current, error))
+	{
+		cerr << error << endl;
+		return -1;
+	}
+	map<string, const bench::Result*> byName;
+	for (size_t i=0;i<baseline.size();++i)
+		byName[baseline[i].name] = &baseline[i];
+
+	int regressions = 0, improvements = 0, missing = 0;
+	cout << left << setw(40) << "case" << right << setw(12) << "base ns" << setw(12) << "current ns" << setw(10) << "change" << endl;
+	cout << fixed;
+	for (size_t i=0;i<current.size();++i)
+	{
+		const bench::Result &cur = current[i];
+		map<string, const bench::Result*>::iterator it = byName.find(cur.name);
+		if (it == byName.end())
+			continue;
+		const bench::Result &base = *it->second;
+		byName.erase (it);
+		if (base.time.median <= 0)
+			continue;
+		const double change = cur.time.median / base.time.median - 1.0;
+		// only flag changes that are larger than the threshold and outside the spread of the other run
+		const char *flag = "";
+		if (change > threshold && cur.time.min > base.time.p90)
+		{
+			flag = "  REGRESSION";
+			++regressions;
+		}
+		else if (change < -threshold && cur.time.p90 < base.time.min)
+		{
+			flag = "  improved";
+			++improvements;
+		}
+		cout << left << setw(40) << cur.name << right << setprecision(2)
+			<< setw(12) << base.time.median << setw(12) << cur.time.median
+			<< setprecision(1) << setw(9) << change*100.0 << "%" << flag << endl;
+	}
+	missing = int(byName.size());
+	cout << endl << regressions << " regressions, " << improvements << " improvements";
+	if (missing)
+		cout << ", " << missing << " baseline cases not run";
+	cout << " (threshold " << setprecision(1) << threshold*100.0 << "%)" << endl;
+	return regressions;
+}
+
+int main (int argc, char *argv[])
+{
+	bench::SuiteOptions options;
+	options.threads = noisepp::utils::System::getNumberOfCPUs();
+	string output = "bench.json";
+	int repetitions = 15;
+	double warmup = 0.1;
+	double threshold = 0.05;
+	bool list = false;
+	bool counters = false;
+	bool scaling = false;
+	bool latency = false;
+	bench::LatencyOptions latencyOptions;
+	bench::ScalingOptions scalingOptions;
+	scalingOptions.maxThreads = options.threads;
+	string compareBaseline, compareCurrent;
+
+	for (int i=1;i<argc;++i)
+	{
+		const string arg = argv[i];
+		const bool hasValue = i+1 < argc;
+		if (arg == "--filter" && hasValue)
+			options.filter = argv[++i];
+		else if (arg == "--output" && hasValue)
+			output = argv[++i];
+		else if (arg == "--repetitions" && hasValue)
+			repetitions = atoi(argv[++i]);
+		else if (arg == "--warmup" && hasValue)
+			warmup = atof(argv[++i]);
+		else if (arg == "--threads" && hasValue)
+			options.threads = atoi(argv[++i]);
+		else if (arg == "--threshold" && hasValue)
+			threshold = atof(argv[++i]) / 100.0;
+		else if (arg == "--quick")
+		{
+			repetitions = 5;
+			warmup = 0.02;
+			latencyOptions.queriesPerThread = 20000;
+		}
+		else if (arg == "--scaling")
+			scaling = true;
+		else if (arg == "--latency")
+			latency = true;
+		else if (arg == "--queries" && hasValue)
+			latencyOptions.queriesPerThread = atoi(argv[++i]);
+		else if (arg == "--max-threads" && hasValue)
+			scalingOptions.maxThreads = atoi(argv[++i]);
+		else if (arg == "--counters")
+			counters = true;
+		else if (arg == "--list")
+			list = true;
+		else if (arg == "--compare" && i+2 < argc)
+		{
+			compareBaseline = argv[++i];
+			compareCurrent = argv[++i];
+		}
+		else
+		{
+			printUsage ();
+			return 1;
+		}
+	}
+
+	if (!compareBaseline.empty())
+	{
+		const int regressions = compare(compareBaseline, compareCurrent, threshold);
+		return regressions == 0 ? 0 : 1;
+	}
+
+	vector<bench::Case*> cases;
+	vector<bench::Result> results;
+	vector<bench::ScalingResult> scalingResults;
+	vector<bench::LatencyResult> latencyResults;
+	int ret = 0;
+	try
+	{
+		if (!scaling && !latency)
+			bench::createSuite (options, cases);
+		if (list)
+		{
+			for (size_t i=0;i<cases.size();++i)
+				cout << cases[i]->name << endl;
+		}
+		else
+		{
+			bench::Harness harness;
+			harness.setRepetitions (repetitions);
+			harness.setWarmupTime (warmup);
+			harness.setVerbose (output != "-");
+			// opened before any case creates its worker threads so they inherit the counters
+			bench::PerfCounters perfCounters;
+			if (counters)
+			{
+				if (perfCounters.open())
+					harness.setCounters (&perfCounters);
+				else
+					cerr << "Hardware counters not available: " << perfCounters.getError() << endl;
+			}
+			if (scaling)
+			{
+				scalingOptions.filter = options.filter;
+				bench::runScaling (scalingOptions, harness, scalingResults);
+				for (size_t i=0;i<scalingResults.size();++i)
+					results.push_back (scalingResults[i].timing);
+				bench::printScaling (cerr, scalingResults);
+			}
+			if (latency)
+			{
+				latencyOptions.filter = options.filter;
+				latencyOptions.threads = options.threads;
+				bench::runLatency (latencyOptions, latencyResults);
+				bench::printLatency (cerr, latencyResults);
+			}
+			for (size_t i=0;i<cases.size();++i)
+			{
+				cerr << "[" << (i+1) << "/" << cases.size() << "] ";
+				results.push_back (harness.measure(*cases[i]));
+			}
+
+			bench::RunInfo info;
+			info.hardwareThreads = noisepp::utils::System::getNumberOfCPUs();
+			info.repetitions = repetitions;
+			info.warmupTime = warmup;
+			info.doublePrecision = NOISEPP_DOUBLE_PRECISION != 0;
+			info.timerOverhead = bench::getTimerOverhead();
+			if (output == "-")
+				bench::writeResults (cout, info, results, scalingResults, latencyResults);
+			else
+			{
+				ofstream f(output.c_str());
+				if (!f)
+				{
+					cerr << "Can't open file for writing: " << output << endl;
+					ret = 1;
+				}
+				else
+				{
+					bench::writeResults (f, info, results, scalingResults, latencyResults);
+					cerr << "Results written to " << output << endl;
+				}
+			}
+		}
+	}
+	catch (noisepp::Exception &e)
+	{
+		cerr << "Exception thrown: " << e.getDescription() << endl;
+		ret = 1;
+	}
+
+	for (size_t i=0;i<cases.size();++i)
+		delete cases[i];
+	return ret;
+}
@@ -26,8 +26,6 @@ int main(int argc, char *argv[])
 	}
 	int w, h;
 	w = h = 512;
-	// allocate memory for height data
-	Real *data = new Real[w*h];
 	try
 	{
 		// read data
@@ -35,17 +33,9 @@ int main(int argc, char *argv[])
 		if (reader.getModule() == NULL)
 		{
 			cerr << "File in wrong format or corrupted: " << filename << endl;
-			delete[] data;
 			return 1;
 		}
 	
-		noisepp::utils::PlaneBuilder2D builder;
-		builder.setModule (reader.getModule());
-		builder.setSize (w, h);
-		builder.setBounds (0, 0, 5, 5);
-		builder.setDestination (data);
-		builder.build ();
-		
 		// create a image
 		noisepp::utils::Image img;
 		img.create (w, h);
@@ -60,7 +50,14 @@ int main(int argc, char *argv[])
 		gradients.addGradient ( 0.3750, noisepp::utils::ColourValue (224, 224,   0)/255.f); // dirt
 		gradients.addGradient ( 0.7500, noisepp::utils::ColourValue (128, 128, 128)/255.f); // rock
 		gradients.addGradient ( 1.0000, noisepp::utils::ColourValue (255, 255, 255)/255.f); // snow
-		gradients.renderImage (img, data);
+
+		// build and colorize in one pass
+		noisepp::utils::PlaneBuilder2D builder;
+		builder.setModule (reader.getModule());
+		builder.setSize (w, h);
+		builder.setBounds (0, 0, 5, 5);
+		builder.setImageDestination (&img, &gradients);
+		builder.build ();
 	
 		f.close ();
 
@@ -70,8 +67,5 @@ int main(int argc, char *argv[])
 	{
 		cerr << "Exception thrown: " << e.what() << endl;
 	}
-	delete[] data;
-	data = 0;
-	
 	return 0;
 }
@@ -31,6 +31,8 @@
 #include "NoiseMath.h"
 #include "NoisePipeline.h"
 #include "NoisePipelineJobs.h"
+#include "NoiseJobTracer.h"
+#include "NoisePointQuery.h"
 #include "NoiseModule.h"
 #include "NoisePerlin.h"
 #include "NoiseBillow.h"
@@ -55,6 +57,7 @@
 #include "NoiseTerrace.h"
 #include "NoiseTranslatePoint.h"
 #include "NoiseVoronoi.h"
+#include "NoiseBakedGrid.h"
 
 #if NOISEPP_ENABLE_THREADS
 #include "NoiseThreadedPipeline.h"
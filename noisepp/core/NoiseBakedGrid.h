@@ -0,0 +1,454 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPP_BAKEDGRID_H
+#define NOISEPP_BAKEDGRID_H
+
+#include "NoisePipeline.h"
+#include "NoisePipelineJobs.h"
+#include "NoiseModule.h"
+#include "NoiseMath.h"
+
+namespace noisepp
+{
+	enum { BAKEDGRID_INTERPOLATION_LINEAR=0, BAKEDGRID_INTERPOLATION_CUBIC=1 };
+	enum { BAKEDGRID_OUTSIDE_SOURCE=0, BAKEDGRID_OUTSIDE_WRAP=1, BAKEDGRID_OUTSIDE_CLAMP=2 };
+
+	/// Maps a coordinate to the samples of one grid axis.
+	class BakedGridAxis
+	{
+		private:
+			Real mLower;
+			Real mDelta;
+			Real mScale;
+			int mResolution;
+			int mOutsideMode;
+
+			NOISEPP_INLINE int getIndex (int i) const
+			{
+				if (mOutsideMode == BAKEDGRID_OUTSIDE_WRAP)
+				{
+					i %= mResolution;
+					return i < 0 ? i + mResolution : i;
+				}
+				return i < 0 ? 0 : (i >= mResolution ? mResolution-1 : i);
+			}
+
+		public:
+			BakedGridAxis (Real lower, Real upper, int resolution, int outsideMode) :
+				mLower(lower), mResolution(resolution), mOutsideMode(outsideMode)
+			{
+				// a wrapping grid is periodic, so the upper bound is the same sample as the lower bound
+				mDelta = (upper - lower) / Real(outsideMode == BAKEDGRID_OUTSIDE_WRAP ? resolution : resolution-1);
+				mScale = Real(1) / mDelta;
+			}
+			/// Returns the coordinate of the specified sample.
+			Real getPosition (int i) const
+			{
+				return mLower + mDelta * i;
+			}
+			/// Returns the distance between two samples.
+			Real getDelta () const
+			{
+				return mDelta;
+			}
+			/// Returns the number of samples.
+			int getResolution () const
+			{
+				return mResolution;
+			}
+			/// Returns the indices of the four samples around the coordinate and the position between the middle ones.
+			/// Returns false if the coordinate is outside of the grid and the source module has to be used.
+			NOISEPP_INLINE bool locate (Real v, int *indices, Real &frac) const
+			{
+				Real pos = (v - mLower) * mScale;
+				if (mOutsideMode == BAKEDGRID_OUTSIDE_WRAP)
+				{
+					pos = fmod (pos, Real(mResolution));
+					if (pos < 0)
+						pos += Real(mResolution);
+				}
+				else if (pos < 0 || pos > Real(mResolution-1))
+				{
+					if (mOutsideMode == BAKEDGRID_OUTSIDE_SOURCE)
+						return false;
+					pos = pos < 0 ? Real(0) : Real(mResolution-1);
+				}
+				const Real fl = floor (pos);
+				const int i = int(fl);
+				frac = pos - fl;
+				indices[0] = getIndex (i-1);
+				indices[1] = getIndex (i);
+				indices[2] = getIndex (i+1);
+				indices[3] = getIndex (i+2);
+				return true;
+			}
+	};
+
+	class BakedGridElement1D : public PipelineElement1D
+	{
+		private:
+			ElementID mElement;
+			const PipelineElement1D *mElementPtr;
+			BakedGridAxis mAxisX;
+			int mInterpolation;
+			std::vector<Real> mGrid;
+
+		public:
+			BakedGridElement1D (const Pipeline1D *pipe, ElementID element, const BakedGridAxis &axisX, int interpolation) :
+				mElement(element), mAxisX(axisX), mInterpolation(interpolation), mGrid(axisX.getResolution())
+			{
+				mElementPtr = pipe->getElement(mElement);
+			}
+			/// Evaluates the source module at every grid sample.
+			void bake (Pipeline1D *pipe)
+			{
+				pipe->addJob (new LineJob1D(pipe, pipe->getElement(mElement), mAxisX.getPosition(0), mAxisX.getResolution(), mAxisX.getDelta(), &mGrid[0]));
+				pipe->executeJobs ();
+			}
+			virtual Real getValue (Real x, Cache *cache) const
+			{
+				int ix[4];
+				Real fx;
+				if (!mAxisX.locate (x, ix, fx))
+					return getElementValue (mElementPtr, mElement, x, cache);
+				const Real *g = &mGrid[0];
+				if (mInterpolation == BAKEDGRID_INTERPOLATION_CUBIC)
+					return Math::InterpCubic (g[ix[0]], g[ix[1]], g[ix[2]], g[ix[3]], fx);
+				return Math::InterpLinear (g[ix[1]], g[ix[2]], fx);
+			}
+	};
+
+	class BakedGridElement2D : public PipelineElement2D
+	{
+		private:
+			ElementID mElement;
+			const PipelineElement2D *mElementPtr;
+			BakedGridAxis mAxisX, mAxisY;
+			int mInterpolation;
+			std::vector<Real> mGrid;
+
+		public:
+			BakedGridElement2D (const Pipeline2D *pipe, ElementID element, const BakedGridAxis &axisX, const BakedGridAxis &axisY, int interpolation) :
+				mElement(element), mAxisX(axisX), mAxisY(axisY), mInterpolation(interpolation), mGrid(axisX.getResolution()*axisY.getResolution())
+			{
+				mElementPtr = pipe->getElement(mElement);
+			}
+			/// Evaluates the source module at every grid sample, one job per row.
+			void bake (Pipeline2D *pipe)
+			{
+				const int width = mAxisX.getResolution ();
+				for (int y=0;y<mAxisY.getResolution();++y)
+				{
+					pipe->addJob (new LineJob2D(pipe, pipe->getElement(mElement), mAxisX.getPosition(0), mAxisY.getPosition(y), width, mAxisX.getDelta(), &mGrid[y*width]));
+				}
+				pipe->executeJobs ();
+			}
+			virtual Real getValue (Real x, Real y, Cache *cache) const
+			{
+				int ix[4], iy[4];
+				Real fx, fy;
+				if (!mAxisX.locate (x, ix, fx) || !mAxisY.locate (y, iy, fy))
+					return getElementValue (mElementPtr, mElement, x, y, cache);
+				const int width = mAxisX.getResolution ();
+				const Real *g = &mGrid[0];
+				if (mInterpolation == BAKEDGRID_INTERPOLATION_CUBIC)
+				{
+					Real v[4];
+					for (int j=0;j<4;++j)
+					{
+						const Real *row = g + iy[j]*width;
+						v[j] = Math::InterpCubic (row[ix[0]], row[ix[1]], row[ix[2]], row[ix[3]], fx);
+					}
+					return Math::InterpCubic (v[0], v[1], v[2], v[3], fy);
+				}
+				const Real *row0 = g + iy[1]*width;
+				const Real *row1 = g + iy[2]*width;
+				return Math::InterpLinear (Math::InterpLinear (row0[ix[1]], row0[ix[2]], fx), Math::InterpLinear (row1[ix[1]], row1[ix[2]], fx), fy);
+			}
+	};
+
+	class BakedGridElement3D : public PipelineElement3D
+	{
+		private:
+			ElementID mElement;
+			const PipelineElement3D *mElementPtr;
+			BakedGridAxis mAxisX, mAxisY, mAxisZ;
+			int mInterpolation;
+			std::vector<Real> mGrid;
+
+		public:
+			BakedGridElement3D (const Pipeline3D *pipe, ElementID element, const BakedGridAxis &axisX, const BakedGridAxis &axisY, const BakedGridAxis &axisZ, int interpolation) :
+				mElement(element), mAxisX(axisX), mAxisY(axisY), mAxisZ(axisZ), mInterpolation(interpolation),
+				mGrid(axisX.getResolution()*axisY.getResolution()*axisZ.getResolution())
+			{
+				mElementPtr = pipe->getElement(mElement);
+			}
+			/// Evaluates the source module at every grid sample, one job per row.
+			void bake (Pipeline3D *pipe)
+			{
+				const int width = mAxisX.getResolution ();
+				const int height = mAxisY.getResolution ();
+				for (int z=0;z<mAxisZ.getResolution();++z)
+				{
+					for (int y=0;y<height;++y)
+					{
+						pipe->addJob (new LineJob3D(pipe, pipe->getElement(mElement), mAxisX.getPosition(0), mAxisY.getPosition(y), mAxisZ.getPosition(z), width, mAxisX.getDelta(), &mGrid[(z*height+y)*width]));
+					}
+				}
+				pipe->executeJobs ();
+			}
+			virtual Real getValue (Real x, Real y, Real z, Cache *cache) const
+			{
+				int ix[4], iy[4], iz[4];
+				Real fx, fy, fz;
+				if (!mAxisX.locate (x, ix, fx) || !mAxisY.locate (y, iy, fy) || !mAxisZ.locate (z, iz, fz))
+					return getElementValue (mElementPtr, mElement, x, y, z, cache);
+				const int width = mAxisX.getResolution ();
+				const int slice = width * mAxisY.getResolution ();
+				const Real *g = &mGrid[0];
+				if (mInterpolation == BAKEDGRID_INTERPOLATION_CUBIC)
+				{
+					Real w[4];
+					for (int k=0;k<4;++k)
+					{
+						Real v[4];
+						for (int j=0;j<4;++j)
+						{
+							const Real *row = g + iz[k]*slice + iy[j]*width;
+							v[j] = Math::InterpCubic (row[ix[0]], row[ix[1]], row[ix[2]], row[ix[3]], fx);
+						}
+						w[k] = Math::InterpCubic (v[0], v[1], v[2], v[3], fy);
+					}
+					return Math::InterpCubic (w[0], w[1], w[2], w[3], fz);
+				}
+				Real w[2];
+				for (int k=0;k<2;++k)
+				{
+					const Real *row0 = g + iz[k+1]*slice + iy[1]*width;
+					const Real *row1 = g + iz[k+1]*slice + iy[2]*width;
+					w[k] = Math::InterpLinear (Math::InterpLinear (row0[ix[1]], row0[ix[2]], fx), Math::InterpLinear (row1[ix[1]], row1[ix[2]], fx), fy);
+				}
+				return Math::InterpLinear (w[0], w[1], fz);
+			}
+	};
+
+	/** Module for baking the source module to a grid.
+		When added to a pipeline the source module is evaluated once at every sample of a regular grid over the
+		specified bounds (in parallel using the jobs of the pipeline). The output is interpolated from that grid,
+		which is a lot faster for expensive but slowly changing sources.
+		Outside of the bounds the source module is used, or the grid is repeated or clamped (see setOutsideMode()).
+		1D pipelines use the x-axis, 2D pipelines the x- and y-axis. Each pipeline holds its own copy of the grid,
+		which needs resolutionX * resolutionY * resolutionZ values in 3D.
+	*/
+	class BakedGridModule : public Module
+	{
+		private:
+			Real mLowerBoundX, mLowerBoundY, mLowerBoundZ;
+			Real mUpperBoundX, mUpperBoundY, mUpperBoundZ;
+			int mResolutionX, mResolutionY, mResolutionZ;
+			int mInterpolation;
+			int mOutsideMode;
+
+		public:
+			/// Constructor.
+			BakedGridModule() : Module(1), mLowerBoundX(-1.0), mLowerBoundY(-1.0), mLowerBoundZ(-1.0), mUpperBoundX(1.0), mUpperBoundY(1.0), mUpperBoundZ(1.0),
+				mResolutionX(128), mResolutionY(128), mResolutionZ(128), mInterpolation(BAKEDGRID_INTERPOLATION_LINEAR), mOutsideMode(BAKEDGRID_OUTSIDE_SOURCE)
+			{
+			}
+			/// Sets the grid bounds for 1D pipelines.
+			void setBounds (Real lowerBoundX, Real upperBoundX)
+			{
+				NoiseAssert (lowerBoundX < upperBoundX, lowerBoundX);
+				mLowerBoundX = lowerBoundX;
+				mUpperBoundX = upperBoundX;
+			}
+			/// Sets the grid bounds for 2D pipelines.
+			void setBounds (Real lowerBoundX, Real lowerBoundY, Real upperBoundX, Real upperBoundY)
+			{
+				NoiseAssert (lowerBoundY < upperBoundY, lowerBoundY);
+				setBounds (lowerBoundX, upperBoundX);
+				mLowerBoundY = lowerBoundY;
+				mUpperBoundY = upperBoundY;
+			}
+			/// Sets the grid bounds for 3D pipelines.
+			void setBounds (Real lowerBoundX, Real lowerBoundY, Real lowerBoundZ, Real upperBoundX, Real upperBoundY, Real upperBoundZ)
+			{
+				NoiseAssert (lowerBoundZ < upperBoundZ, lowerBoundZ);
+				setBounds (lowerBoundX, lowerBoundY, upperBoundX, upperBoundY);
+				mLowerBoundZ = lowerBoundZ;
+				mUpperBoundZ = upperBoundZ;
+			}
+			/// Returns the x-coordinate of the lower bound.
+			Real getLowerBoundX () const
+			{
+				return mLowerBoundX;
+			}
+			/// Returns the y-coordinate of the lower bound.
+			Real getLowerBoundY () const
+			{
+				return mLowerBoundY;
+			}
+			/// Returns the z-coordinate of the lower bound.
+			Real getLowerBoundZ () const
+			{
+				return mLowerBoundZ;
+			}
+			/// Returns the x-coordinate of the upper bound.
+			Real getUpperBoundX () const
+			{
+				return mUpperBoundX;
+			}
+			/// Returns the y-coordinate of the upper bound.
+			Real getUpperBoundY () const
+			{
+				return mUpperBoundY;
+			}
+			/// Returns the z-coordinate of the upper bound.
+			Real getUpperBoundZ () const
+			{
+				return mUpperBoundZ;
+			}
+			/// Sets the number of grid samples along each axis (at least 2).
+			void setResolution (int x, int y, int z)
+			{
+				NoiseAssert (x > 1, x);
+				NoiseAssert (y > 1, y);
+				NoiseAssert (z > 1, z);
+				mResolutionX = x;
+				mResolutionY = y;
+				mResolutionZ = z;
+			}
+			/// Returns the number of grid samples along the x-axis.
+			int getResolutionX () const
+			{
+				return mResolutionX;
+			}
+			/// Returns the number of grid samples along the y-axis.
+			int getResolutionY () const
+			{
+				return mResolutionY;
+			}
+			/// Returns the number of grid samples along the z-axis.
+			int getResolutionZ () const
+			{
+				return mResolutionZ;
+			}
+			/// Sets the interpolation (BAKEDGRID_INTERPOLATION_LINEAR or BAKEDGRID_INTERPOLATION_CUBIC).
+			void setInterpolation (int v)
+			{
+				NoiseAssert (v == BAKEDGRID_INTERPOLATION_LINEAR || v == BAKEDGRID_INTERPOLATION_CUBIC, v);
+				mInterpolation = v;
+			}
+			/// Returns the interpolation.
+			int getInterpolation () const
+			{
+				return mInterpolation;
+			}
+			/// Sets what happens outside of the bounds.
+			/// BAKEDGRID_OUTSIDE_SOURCE uses the source module, BAKEDGRID_OUTSIDE_WRAP repeats the grid (the source should be seamless)
+			/// and BAKEDGRID_OUTSIDE_CLAMP uses the nearest border sample.
+			void setOutsideMode (int v)
+			{
+				NoiseAssert (v == BAKEDGRID_OUTSIDE_SOURCE || v == BAKEDGRID_OUTSIDE_WRAP || v == BAKEDGRID_OUTSIDE_CLAMP, v);
+				mOutsideMode = v;
+			}
+			/// Returns what happens outside of the bounds.
+			int getOutsideMode () const
+			{
+				return mOutsideMode;
+			}
+			/// @copydoc noisepp::Module::addToPipeline()
+			ElementID addToPipeline (Pipeline1D *pipe) const
+			{
+				NoiseModuleReturnExistingElement (pipe);
+				NoiseModuleCheckSourceModules;
+				ElementID first = getSourceModule(0)->addToPipeline(pipe);
+				BakedGridElement1D *element = new BakedGridElement1D(pipe, first,
+					BakedGridAxis(mLowerBoundX, mUpperBoundX, mResolutionX, mOutsideMode), mInterpolation);
+				try
+				{
+					element->bake (pipe);
+				}
+				catch (...)
+				{
+					delete element;
+					throw;
+				}
+				return pipe->addElement (this, element);
+			}
+			/// @copydoc noisepp::Module::addToPipeline()
+			ElementID addToPipeline (Pipeline2D *pipe) const
+			{
+				NoiseModuleReturnExistingElement (pipe);
+				NoiseModuleCheckSourceModules;
+				ElementID first = getSourceModule(0)->addToPipeline(pipe);
+				BakedGridElement2D *element = new BakedGridElement2D(pipe, first,
+					BakedGridAxis(mLowerBoundX, mUpperBoundX, mResolutionX, mOutsideMode),
+					BakedGridAxis(mLowerBoundY, mUpperBoundY, mResolutionY, mOutsideMode), mInterpolation);
+				try
+				{
+					element->bake (pipe);
+				}
+				catch (...)
+				{
+					delete element;
+					throw;
+				}
+				return pipe->addElement (this, element);
+			}
+			/// @copydoc noisepp::Module::addToPipeline()
+			ElementID addToPipeline (Pipeline3D *pipe) const
+			{
+				NoiseModuleReturnExistingElement (pipe);
+				NoiseModuleCheckSourceModules;
+				ElementID first = getSourceModule(0)->addToPipeline(pipe);
+				BakedGridElement3D *element = new BakedGridElement3D(pipe, first,
+					BakedGridAxis(mLowerBoundX, mUpperBoundX, mResolutionX, mOutsideMode),
+					BakedGridAxis(mLowerBoundY, mUpperBoundY, mResolutionY, mOutsideMode),
+					BakedGridAxis(mLowerBoundZ, mUpperBoundZ, mResolutionZ, mOutsideMode), mInterpolation);
+				try
+				{
+					element->bake (pipe);
+				}
+				catch (...)
+				{
+					delete element;
+					throw;
+				}
+				return pipe->addElement (this, element);
+			}
+			/// @copydoc noisepp::Module::getType()
+			ModuleTypeId getType() const { return MODULE_BAKEDGRID; }
+#if NOISEPP_ENABLE_UTILS
+			/// @copydoc noisepp::Module::write()
+			virtual void write (utils::OutStream &stream) const;
+			/// @copydoc noisepp::Module::read()
+			virtual void read (utils::InStream &stream);
+#endif
+	};
+};
+
+#endif
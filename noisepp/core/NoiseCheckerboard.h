@@ -71,16 +71,19 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new CheckerboardElement1D);
 			}
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new CheckerboardElement2D);
 			}
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new CheckerboardElement3D);
 			}
 			/// @copydoc noisepp::Module::getType()
@@ -139,6 +139,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				return pipe->addElement (this, new ClampElement1D(pipe, first, mLowerBound, mUpperBound));
@@ -146,6 +147,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				return pipe->addElement (this, new ClampElement2D(pipe, first, mLowerBound, mUpperBound));
@@ -153,6 +155,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				return pipe->addElement (this, new ClampElement3D(pipe, first, mLowerBound, mUpperBound));
@@ -43,4 +43,14 @@
 #define NOISEPP_ENABLE_UTILS 1
 #endif
 
+// Defines whether pipelines collect per-element evaluation counters and timings (see Pipeline::getProfile())
+#ifndef NOISEPP_ENABLE_PROFILING
+#define NOISEPP_ENABLE_PROFILING 0
+#endif
+
+// Every n-th evaluation of an element is timed together with its source elements
+#ifndef NOISEPP_PROFILING_SAMPLE_RATE
+#define NOISEPP_PROFILING_SAMPLE_RATE 64
+#endif
+
 #endif
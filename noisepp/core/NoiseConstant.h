@@ -85,16 +85,19 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new ConstantElement1D(mValue));
 			}
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new ConstantElement2D(mValue));
 			}
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new ConstantElement3D(mValue));
 			}
 			/// @copydoc noisepp::Module::getType()
@@ -0,0 +1,179 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPP_JOBTRACER_H
+#define NOISEPP_JOBTRACER_H
+
+#include <cstdio>
+
+#include "NoisePrerequisites.h"
+#include "NoiseTimer.h"
+
+namespace noisepp
+{
+	/** Records the timeline of jobs executed by a ThreadedPipeline or utils::ThreadedJobQueue.
+		Every thread writes to its own ring buffer without locking, when a buffer is full the oldest events are overwritten.
+		Attach the tracer with setTracer() before adding jobs and read the events (or export them with
+		utils::TraceWriter) when no jobs are running. The tracer can be shared by several executors.
+	*/
+	class JobTracer
+	{
+		public:
+			/// Event types.
+			enum EventType
+			{
+				/// The job was added to the queue.
+				EVENT_ENQUEUE=0,
+				/// A worker thread started executing the job.
+				EVENT_EXECUTE_BEGIN,
+				/// A worker thread finished executing the job.
+				EVENT_EXECUTE_END,
+				/// The main thread started the finish() callback of the job.
+				EVENT_FINISH_BEGIN,
+				/// The main thread returned from the finish() callback of the job.
+				EVENT_FINISH_END,
+				/// The main thread started waiting for finished jobs.
+				EVENT_WAIT_BEGIN,
+				/// The main thread stopped waiting.
+				EVENT_WAIT_END
+			};
+			/// A recorded event.
+			struct Event
+			{
+				/// Time stamp in seconds (see Timer::getTime()).
+				double time;
+				/// The job, NULL for wait events.
+				const void *job;
+				/// The event type.
+				EventType type;
+			};
+			/// Event ring buffer of one thread.
+			class ThreadBuffer
+			{
+				friend class JobTracer;
+				private:
+					std::string mName;
+					std::vector<Event> mEvents;
+					unsigned long mCount;
+
+					ThreadBuffer (const std::string &name, size_t capacity) : mName(name), mEvents(capacity), mCount(0)
+					{}
+				public:
+					/// Records an event, only the thread owning the buffer may call this.
+					NOISEPP_INLINE void record (EventType type, const void *job)
+					{
+						Event &e = mEvents[mCount % mEvents.size()];
+						e.time = Timer::getTime ();
+						e.job = job;
+						e.type = type;
+						++mCount;
+					}
+					/// Returns the thread name.
+					const std::string &getName () const
+					{
+						return mName;
+					}
+					/// Returns the number of events that have been overwritten.
+					unsigned long getLostEventCount () const
+					{
+						return mCount > mEvents.size() ? mCount - mEvents.size() : 0;
+					}
+					/// Copies the recorded events in chronological order.
+					void getEvents (std::vector<Event> &events) const
+					{
+						const unsigned long capacity = mEvents.size ();
+						const unsigned long first = mCount > capacity ? mCount - capacity : 0;
+						events.clear ();
+						events.reserve (mCount - first);
+						for (unsigned long i=first;i<mCount;++i)
+							events.push_back (mEvents[i % capacity]);
+					}
+			};
+
+		private:
+			std::vector<ThreadBuffer*> mBuffers;
+			size_t mCapacity;
+			int mWorkerCount;
+#if NOISEPP_ENABLE_THREADS
+			threadpp::Mutex mMutex;
+#endif
+
+			JobTracer (const JobTracer &);
+			JobTracer &operator= (const JobTracer &);
+		public:
+			/// Constructor.
+			/// @param eventsPerThread The size of the ring buffer of each thread.
+			JobTracer (size_t eventsPerThread=65536) : mCapacity(eventsPerThread), mWorkerCount(0)
+			{
+				NoiseAssert (eventsPerThread > 0, eventsPerThread);
+			}
+			/// Creates the buffer for a thread, used by the executors.
+			/// @param worker true for a worker thread (the name gets a number), false for the thread controlling the executor.
+			ThreadBuffer *registerThread (bool worker)
+			{
+#if NOISEPP_ENABLE_THREADS
+				threadpp::Mutex::Lock lk(mMutex);
+#endif
+				std::string name = "main";
+				if (worker)
+				{
+					char buffer[32];
+					sprintf (buffer, "worker %d", ++mWorkerCount);
+					name = buffer;
+				}
+				ThreadBuffer *buffer = new ThreadBuffer(name, mCapacity);
+				mBuffers.push_back (buffer);
+				return buffer;
+			}
+			/// Returns the number of thread buffers.
+			size_t getThreadCount () const
+			{
+				return mBuffers.size ();
+			}
+			/// Returns a thread buffer.
+			const ThreadBuffer *getThread (size_t i) const
+			{
+				NoiseAssertRange (i, mBuffers.size());
+				return mBuffers[i];
+			}
+			/// Removes all recorded events, call this when no jobs are running.
+			void clear ()
+			{
+#if NOISEPP_ENABLE_THREADS
+				threadpp::Mutex::Lock lk(mMutex);
+#endif
+				for (size_t i=0;i<mBuffers.size();++i)
+					mBuffers[i]->mCount = 0;
+			}
+			/// Destructor, the executors using the tracer must be destroyed before.
+			~JobTracer ()
+			{
+				for (size_t i=0;i<mBuffers.size();++i)
+					delete mBuffers[i];
+			}
+	};
+};
+
+#endif // NOISEPP_JOBTRACER_H
@@ -31,7 +31,6 @@
 
 namespace noisepp
 {
-	typedef unsigned short ModuleTypeId;
 	enum
 	{
 		MODULE_PERLIN=0,
@@ -56,7 +55,8 @@ namespace noisepp
 		MODULE_TURBULENCE=19,
 		MODULE_TERRACE=20,
 		MODULE_TRANSLATEPOINT=21,
-		MODULE_VORONOI=22
+		MODULE_VORONOI=22,
+		MODULE_BAKEDGRID=23
 	};
 
 #if NOISEPP_ENABLE_UTILS
@@ -94,6 +94,15 @@ namespace noisepp
 			/// Recursively looks for the specified module in all source modules.
 			/// @param module The module to look for.
 			bool walkTree (const Module *module) const
+			{
+				std::set<const Module*> visited;
+				return walkTree (module, visited);
+			}
+			/// Recursively looks for the specified module in all source modules.
+			/// Shared source modules are only searched once.
+			/// @param module The module to look for.
+			/// @param visited The modules already searched.
+			bool walkTree (const Module *module, std::set<const Module*> &visited) const
 			{
 				for (size_t i=0;i<mSourceModuleCount;++i)
 				{
@@ -102,7 +111,7 @@ namespace noisepp
 				}
 				for (size_t i=0;i<mSourceModuleCount;++i)
 				{
-					if (mSourceModules[i] && mSourceModules[i]->walkTree(module))
+					if (mSourceModules[i] && visited.insert(mSourceModules[i]).second && mSourceModules[i]->walkTree(module, visited))
 						return true;
 				}
 				return false;
@@ -129,6 +138,17 @@ namespace noisepp
 				NoiseAssertRange (id, mSourceModuleCount);
 				return mSourceModules[id];
 			}
+			/// Returns the number of modules the module adds to a pipeline itself, besides its source modules.
+			virtual size_t getInternalModuleCount () const
+			{
+				return 0;
+			}
+			/// Returns the specified internal module.
+			virtual const Module *getInternalModule (size_t id) const
+			{
+				NoiseAssertRange (id, getInternalModuleCount());
+				return NULL;
+			}
 			/// Adds the module to the specified pipeline.
 			virtual ElementID addToPipeline (Pipeline1D *pipe) const = 0;
 			/// Adds the module to the specified pipeline.
@@ -168,6 +188,26 @@ namespace noisepp
 #endif
 	};
 
+	// defined here because it needs the module type
+	template <class Element>
+	ElementID Pipeline<Element>::addElement (const Module *parent, Element *element)
+	{
+		NoiseAssert (element != NULL, element);
+		NoiseAssert (parent != NULL, parent);
+		std::map<const Module*, ElementID>::iterator it = mElementIDs.find(parent);
+		if (it != mElementIDs.end())
+		{
+			delete element;
+			return it->second;
+		}
+		ElementID id = mElements.size ();
+		mElementIDs.insert (std::make_pair(parent, id));
+		mElements.push_back(element);
+		mElementModules.push_back(parent);
+		mElementTypes.push_back(parent->getType());
+		return id;
+	}
+
 	#define NoiseModuleCheckSourceModules \
 		for (size_t n=0;n<mSourceModuleCount;++n) \
 		{ \
@@ -175,6 +215,15 @@ namespace noisepp
 				NoiseThrowNoModuleException; \
 		}
 
+	/// Returns the element ID if the module was already added to the pipeline.
+	/// Shared source modules are only built once this way.
+	#define NoiseModuleReturnExistingElement(pipe) \
+		{ \
+			ElementID existing = pipe->getElementID(this); \
+			if (existing != ELEMENTID_INVALID) \
+				return existing; \
+		}
+
 	/// Template class for a module with one source module
 	template <class Element1D, class Element2D, class Element3D>
 	class SingleSourceModule : public Module
@@ -187,6 +236,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				return pipe->addElement (this, new Element1D(pipe, first));
@@ -194,6 +244,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				return pipe->addElement (this, new Element2D(pipe, first));
@@ -201,6 +252,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				return pipe->addElement (this, new Element3D(pipe, first));
@@ -219,6 +271,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID second = getSourceModule(1)->addToPipeline(pipe);
@@ -227,6 +280,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID second = getSourceModule(1)->addToPipeline(pipe);
@@ -235,6 +289,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID second = getSourceModule(1)->addToPipeline(pipe);
@@ -275,6 +330,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID second = getSourceModule(1)->addToPipeline(pipe);
@@ -284,6 +340,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID second = getSourceModule(1)->addToPipeline(pipe);
@@ -293,6 +350,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID second = getSourceModule(1)->addToPipeline(pipe);
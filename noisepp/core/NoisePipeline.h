@@ -27,6 +27,7 @@
 #define NOISEPP_PIPELINE_H
 
 #include "NoisePrerequisites.h"
+#include "NoiseProfiler.h"
 
 namespace noisepp
 {
@@ -45,10 +46,58 @@ namespace noisepp
 		Real y;
 		/// Last z coordinate.
 		Real z;
+#if NOISEPP_ENABLE_PROFILING
+		/// Profiling counters of the element.
+		ProfileCounters profile;
+		/// Profiling state, only used in the hidden entry in front of the first element.
+		ProfileThreadState thread;
+#endif
 		/// Constructor.
 		Cache () : value(0), filled(false) {}
 	};
 
+#if NOISEPP_ENABLE_PROFILING
+	/// Counts and times an element evaluation.
+	/// A cache created by a pipeline has a hidden entry in front of the first element, which holds the timing state of the thread.
+	class ProfileScope
+	{
+		private:
+			ProfileThreadState &mThread;
+			ProfileCounters &mCounters;
+			double mStart;
+			double mParentChildTime;
+			bool mTimed, mRoot;
+
+		public:
+			NOISEPP_INLINE ProfileScope (Cache *cache, ElementID element) : mThread(cache[-1].thread), mCounters(cache[element].profile), mStart(0), mParentChildTime(0)
+			{
+				++mCounters.misses;
+				mRoot = !mThread.timing && (mCounters.misses % NOISEPP_PROFILING_SAMPLE_RATE) == 0;
+				mTimed = mThread.timing || mRoot;
+				if (mTimed)
+				{
+					mThread.timing = true;
+					mParentChildTime = mThread.childTime;
+					mThread.childTime = 0;
+					mStart = Timer::getTime ();
+				}
+			}
+			NOISEPP_INLINE ~ProfileScope ()
+			{
+				if (mTimed)
+				{
+					const double time = Timer::getTime () - mStart;
+					++mCounters.samples;
+					mCounters.inclusiveTime += time;
+					mCounters.exclusiveTime += time - mThread.childTime;
+					mThread.childTime = mParentChildTime + time;
+					if (mRoot)
+						mThread.timing = false;
+				}
+			}
+	};
+#endif
+
 	/// A job which can be added to the queue inside a pipeline for multi-threaded execution.
 	class PipelineJob
 	{
@@ -84,8 +133,22 @@ namespace noisepp
 			std::vector<Element*> mElements;
 			/// Map holding the module pointers.
 			std::map<const Module*, ElementID> mElementIDs;
+			/// The module of each element.
+			std::vector<const Module*> mElementModules;
+			/// The module type of each element, valid after the modules are gone.
+			std::vector<ModuleTypeId> mElementTypes;
 			/// The job queue.
 			PipelineJobQueue mJobs;
+#if NOISEPP_ENABLE_PROFILING
+			/// Counters of the freed caches.
+			std::vector<ProfileCounters> mProfile;
+			/// Caches currently in use.
+			std::set<Cache*> mProfileCaches;
+#if NOISEPP_ENABLE_THREADS
+			/// Protects the profiling data, caches are created by worker threads.
+			mutable threadpp::Mutex mProfileMutex;
+#endif
+#endif
 
 		public:
 			/// Constructor.
@@ -120,36 +183,92 @@ namespace noisepp
 			/// Don't forget to free the cache.
 			Cache *createCache () const
 			{
+#if NOISEPP_ENABLE_PROFILING
+				// the hidden first entry holds the timing state of the thread
+				Cache *cache = new Cache[mElements.size()+1] + 1;
+				cache[-1].thread.elementCount = mElements.size();
+				Pipeline<Element> *self = const_cast<Pipeline<Element>*>(this);
+#if NOISEPP_ENABLE_THREADS
+				threadpp::Mutex::Lock lk(mProfileMutex);
+#endif
+				self->mProfileCaches.insert (cache);
+				return cache;
+#else
 				return new Cache[mElements.size()];
+#endif
 			}
 			/// Cleans the specified cache.
 			/// You should call this each time you use it.
 			NOISEPP_INLINE void cleanCache (Cache *cache) const
 			{
+#if NOISEPP_ENABLE_PROFILING
+				// keeps the profiling counters
+				const size_t n = mElements.size();
+				for (size_t i=0;i<n;++i)
+					cache[i].filled = false;
+#else
 				memset (cache, 0, sizeof(Cache)*mElements.size());
+#endif
 			}
 			/// Frees the specified cache.
 			void freeCache (Cache *cache) const
 			{
+#if NOISEPP_ENABLE_PROFILING
+				Pipeline<Element> *self = const_cast<Pipeline<Element>*>(this);
+				{
+#if NOISEPP_ENABLE_THREADS
+					threadpp::Mutex::Lock lk(mProfileMutex);
+#endif
+					// the counters of the freed cache are kept
+					const size_t n = std::min(mElements.size(), cache[-1].thread.elementCount);
+					if (self->mProfile.size() < n)
+						self->mProfile.resize (n);
+					for (size_t i=0;i<n;++i)
+						self->mProfile[i].add (cache[i].profile);
+					self->mProfileCaches.erase (cache);
+				}
+				delete[] (cache - 1);
+#else
 				delete[] cache;
+#endif
 			}
-			/// Adds the specified element to the pipeline.
-			/// This is used internally by modules.
-			ElementID addElement (const Module *parent, Element *element)
+#if NOISEPP_ENABLE_PROFILING
+			/// Returns the profiling counters of every element, summed up over all caches (and thus threads).
+			/// The counters of the element passed to a builder only include evaluations where it is used as source of another element.
+			/// Call this when no jobs are running.
+			void getProfile (std::vector<ProfileCounters> &profile) const
 			{
-				NoiseAssert (element != NULL, element);
-				NoiseAssert (parent != NULL, parent);
-				std::map<const Module*, ElementID>::iterator it = mElementIDs.find(parent);
-				if (it != mElementIDs.end())
+#if NOISEPP_ENABLE_THREADS
+				threadpp::Mutex::Lock lk(mProfileMutex);
+#endif
+				profile = mProfile;
+				profile.resize (mElements.size());
+				for (std::set<Cache*>::const_iterator it=mProfileCaches.begin();it!=mProfileCaches.end();++it)
 				{
-					delete element;
-					return it->second;
+					const size_t n = std::min(mElements.size(), (*it)[-1].thread.elementCount);
+					for (size_t i=0;i<n;++i)
+						profile[i].add ((*it)[i].profile);
+				}
+			}
+			/// Resets the profiling counters.
+			/// Call this when no jobs are running.
+			void resetProfile ()
+			{
+#if NOISEPP_ENABLE_THREADS
+				threadpp::Mutex::Lock lk(mProfileMutex);
+#endif
+				mProfile.clear ();
+				for (std::set<Cache*>::const_iterator it=mProfileCaches.begin();it!=mProfileCaches.end();++it)
+				{
+					const size_t n = (*it)[-1].thread.elementCount;
+					for (size_t i=0;i<n;++i)
+						(*it)[i].profile = ProfileCounters();
 				}
-				ElementID id = mElements.size ();
-				mElementIDs.insert (std::make_pair(parent, id));
-				mElements.push_back(element);
-				return id;
 			}
+#endif
+			/// Adds the specified element to the pipeline.
+			/// This is used internally by modules.
+			ElementID addElement (const Module *parent, Element *element);
 			/// Returns the ID of the element belonging to the specified module or ELEMENTID_INVALID if not found.
 			ElementID getElementID (const Module *module) const
 			{
@@ -163,6 +282,19 @@ namespace noisepp
 			{
 				return getElementID(&module);
 			}
+			/// Returns the module the specified element was created from.
+			/// The pipeline doesn't keep the module alive, it is only valid as long as the module exists.
+			const Module *getElementModule (ElementID i) const
+			{
+				NoiseAssertRange (i, mElementModules.size());
+				return mElementModules[i];
+			}
+			/// Returns the type of the module the specified element was created from.
+			ModuleTypeId getElementType (ElementID i) const
+			{
+				NoiseAssertRange (i, mElementTypes.size());
+				return mElementTypes[i];
+			}
 			/// Returns a pointer to the element belonging to the specified module or NULL if not found
 			Element *getElementPtr (const Module *module) const
 			{
@@ -197,8 +329,9 @@ namespace noisepp
 				}
 				freeCache (cache);
 			}
-			/// Destructor.
-			virtual ~Pipeline ()
+			/// Removes all elements, so the pipeline can be reused for other modules.
+			/// Call this when no jobs are running, caches have to be cleaned before they are used again.
+			void clear ()
 			{
 				typename std::vector<Element*>::iterator itEnd = mElements.end();
 				for (typename std::vector<Element*>::iterator it=mElements.begin();it!=itEnd;++it)
@@ -207,6 +340,16 @@ namespace noisepp
 				}
 				mElements.clear ();
 				mElementIDs.clear ();
+				mElementModules.clear ();
+				mElementTypes.clear ();
+#if NOISEPP_ENABLE_PROFILING
+				mProfile.clear ();
+#endif
+			}
+			/// Destructor.
+			virtual ~Pipeline ()
+			{
+				clear ();
 				while (!mJobs.empty())
 				{
 					delete mJobs.front ();
@@ -247,12 +390,18 @@ namespace noisepp
 			{
 				if (cache[element].filled && cache[element].x == x)
 				{
+#if NOISEPP_ENABLE_PROFILING
+					++cache[element].profile.hits;
+#endif
 					return cache[element].value;
 				}
 				else
 				{
 					cache[element].filled = true;
 					cache[element].x = x;
+#if NOISEPP_ENABLE_PROFILING
+					ProfileScope scope(cache, element);
+#endif
 					return (cache[element].value = elementPtr->getValue(x, cache));
 				}
 			}
@@ -270,6 +419,9 @@ namespace noisepp
 			{
 				if (cache[element].filled && cache[element].x == x && cache[element].y == y)
 				{
+#if NOISEPP_ENABLE_PROFILING
+					++cache[element].profile.hits;
+#endif
 					return cache[element].value;
 				}
 				else
@@ -277,6 +429,9 @@ namespace noisepp
 					cache[element].filled = true;
 					cache[element].x = x;
 					cache[element].y = y;
+#if NOISEPP_ENABLE_PROFILING
+					ProfileScope scope(cache, element);
+#endif
 					return (cache[element].value = elementPtr->getValue(x, y, cache));
 				}
 			}
@@ -293,6 +448,9 @@ namespace noisepp
 			{
 				if (cache[element].filled && cache[element].x == x && cache[element].y == y && cache[element].z == z)
 				{
+#if NOISEPP_ENABLE_PROFILING
+					++cache[element].profile.hits;
+#endif
 					return cache[element].value;
 				}
 				else
@@ -301,6 +459,9 @@ namespace noisepp
 					cache[element].x = x;
 					cache[element].y = y;
 					cache[element].z = z;
+#if NOISEPP_ENABLE_PROFILING
+					ProfileScope scope(cache, element);
+#endif
 					return (cache[element].value = elementPtr->getValue(x, y, z, cache));
 				}
 			}
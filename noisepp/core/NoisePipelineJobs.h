@@ -31,6 +31,44 @@
 namespace noisepp
 {
 
+/// A 1D pipeline job that builds a line along the x-axis.
+class LineJob1D : public PipelineJob
+{
+	private:
+		Pipeline1D *mPipe;
+		PipelineElement1D *mElement;
+		Real x;
+		int n;
+		Real xDelta;
+		Real *buffer;
+
+	public:
+		/// Constructor.
+		/// @param pipe The pipeline.
+		/// @param element A pointer to the pipeline element.
+		/// @param x The start x-coordinate.
+		/// @param n The number of pixels to build.
+		/// @param xDelta The delta value the x-coordinate will change each pixel.
+		/// @param buffer A pointer to the output buffer.
+		LineJob1D (Pipeline1D *pipe, PipelineElement1D *element, Real x, int n, Real xDelta, Real *buffer) :
+			mPipe(pipe), mElement(element), x(x), n(n), xDelta(xDelta), buffer(buffer)
+		{
+		}
+		/// @copydoc noisepp::PipelineJob::execute()
+		void execute (Cache *cache)
+		{
+			for (int i=0;i<n;++i)
+			{
+				// cleans the cache
+				mPipe->cleanCache (cache);
+				// calculates the value
+				buffer[i] = mElement->getValue(x, cache);
+				// move on
+				x += xDelta;
+			}
+		}
+};
+
 /// A 2D pipeline job that builds a line along the x-axis.
 class LineJob2D : public PipelineJob
 {
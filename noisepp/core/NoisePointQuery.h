@@ -0,0 +1,252 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPP_POINTQUERY_H
+#define NOISEPP_POINTQUERY_H
+
+#include "NoisePipeline.h"
+
+namespace noisepp
+{
+	/** Thread-safe single point queries on a built pipeline.
+		Every calling thread gets its own cache, created on its first query and freed when the thread exits or the query object
+		is destroyed. Queries don't lock and don't allocate after the first one of a thread.
+		The caches of a thread are kept in a list owned by the thread, which is only freed by the thread itself on exit
+		(not on Windows, where a few bytes per thread are left), so destroying the query never races with exiting threads.
+		Don't change the pipeline while the query object exists and destroy it only when no queries are running.
+		Without NOISEPP_ENABLE_THREADS a single cache is used and the queries are not thread-safe.
+	*/
+	template <class Element>
+	class PointQuery
+	{
+		private:
+			const Pipeline<Element> *mPipe;
+			Element *mElement;
+#if NOISEPP_ENABLE_THREADS
+			struct ThreadSlots;
+			/// The cache of a thread.
+			struct Slot
+			{
+				PointQuery<Element> *owner;
+				Cache *cache;
+				/// The list of the thread.
+				ThreadSlots *thread;
+				Slot *prev, *next;
+			};
+			/// The caches of a thread, owned by the thread.
+			struct ThreadSlots
+			{
+				Slot *first;
+			};
+			threadpp::ThreadLocal mSlot;
+			std::set<Slot*> mSlots;
+			/// Protects the slots and thread lists of all queries.
+			static threadpp::Mutex mSlotMutex;
+			/// The list of the calling thread.
+			static threadpp::ThreadLocal mThreadSlots;
+
+			static void unlinkSlot (Slot *slot)
+			{
+				if (slot->prev)
+					slot->prev->next = slot->next;
+				else
+					slot->thread->first = slot->next;
+				if (slot->next)
+					slot->next->prev = slot->prev;
+			}
+			static void releaseThread (void *p)
+			{
+				ThreadSlots *thread = static_cast<ThreadSlots*>(p);
+				{
+					threadpp::Mutex::Lock lk(mSlotMutex);
+					// slots of destroyed queries were already removed from the list
+					while (thread->first)
+					{
+						Slot *slot = thread->first;
+						thread->first = slot->next;
+						slot->owner->mSlots.erase (slot);
+						slot->owner->mPipe->freeCache (slot->cache);
+						delete slot;
+					}
+				}
+				delete thread;
+			}
+			Slot *createSlot ()
+			{
+				ThreadSlots *thread = static_cast<ThreadSlots*>(mThreadSlots.get());
+				if (!thread)
+				{
+					thread = new ThreadSlots;
+					thread->first = NULL;
+					mThreadSlots.set (thread);
+				}
+				Slot *slot = new Slot;
+				slot->owner = this;
+				slot->cache = mPipe->createCache ();
+				slot->thread = thread;
+				slot->prev = NULL;
+				{
+					threadpp::Mutex::Lock lk(mSlotMutex);
+					slot->next = thread->first;
+					if (slot->next)
+						slot->next->prev = slot;
+					thread->first = slot;
+					mSlots.insert (slot);
+				}
+				mSlot.set (slot);
+				return slot;
+			}
+#else
+			Cache *mCache;
+#endif
+			PointQuery (const PointQuery &);
+			PointQuery &operator= (const PointQuery &);
+
+		protected:
+			/// Returns the clean cache of the calling thread.
+			NOISEPP_INLINE Cache *getCache () const
+			{
+#if NOISEPP_ENABLE_THREADS
+				Slot *slot = static_cast<Slot*>(mSlot.get());
+				if (!slot)
+					slot = const_cast<PointQuery<Element>*>(this)->createSlot ();
+				Cache *cache = slot->cache;
+#else
+				Cache *cache = mCache;
+#endif
+				mPipe->cleanCache (cache);
+				return cache;
+			}
+
+		public:
+			/// Constructor.
+			/// @param pipe The pipeline, it must be complete and stay alive as long as the query object.
+			/// @param element The ID of the element to query.
+			PointQuery (const Pipeline<Element> *pipe, ElementID element) : mPipe(pipe),
+#if NOISEPP_ENABLE_THREADS
+				mSlot()
+#else
+				mCache(NULL)
+#endif
+			{
+				NoiseAssert (pipe != NULL, pipe);
+				mElement = pipe->getElement(element);
+#if !NOISEPP_ENABLE_THREADS
+				mCache = pipe->createCache ();
+#endif
+			}
+			/// Returns the pipeline.
+			const Pipeline<Element> *getPipeline () const
+			{
+				return mPipe;
+			}
+			/// Returns the queried element.
+			Element *getElement () const
+			{
+				return mElement;
+			}
+			/// Returns the number of caches currently allocated (one per thread that queried and is still running).
+			size_t getCacheCount () const
+			{
+#if NOISEPP_ENABLE_THREADS
+				threadpp::Mutex::Lock lk(mSlotMutex);
+				return mSlots.size ();
+#else
+				return 1;
+#endif
+			}
+			/// Destructor.
+			virtual ~PointQuery ()
+			{
+#if NOISEPP_ENABLE_THREADS
+				// an exiting thread frees its list under the same lock, so the lists are valid here
+				threadpp::Mutex::Lock lk(mSlotMutex);
+				for (typename std::set<Slot*>::iterator it=mSlots.begin();it!=mSlots.end();++it)
+				{
+					unlinkSlot (*it);
+					mPipe->freeCache ((*it)->cache);
+					delete *it;
+				}
+				mSlots.clear ();
+#else
+				mPipe->freeCache (mCache);
+#endif
+			}
+	};
+
+#if NOISEPP_ENABLE_THREADS
+	template <class Element>
+	threadpp::Mutex PointQuery<Element>::mSlotMutex;
+	template <class Element>
+	threadpp::ThreadLocal PointQuery<Element>::mThreadSlots(PointQuery<Element>::releaseThread);
+#endif
+
+	/// Thread-safe single point queries on a 1D pipeline.
+	class PointQuery1D : public PointQuery<PipelineElement1D>
+	{
+		public:
+			/// @copydoc noisepp::PointQuery::PointQuery()
+			PointQuery1D (const Pipeline1D *pipe, ElementID element) : PointQuery<PipelineElement1D>(pipe, element)
+			{}
+			/// Returns the value at the specified position.
+			NOISEPP_INLINE Real getValue (Real x) const
+			{
+				Cache *cache = getCache ();
+				return getElement()->getValue (x, cache);
+			}
+	};
+
+	/// Thread-safe single point queries on a 2D pipeline.
+	class PointQuery2D : public PointQuery<PipelineElement2D>
+	{
+		public:
+			/// @copydoc noisepp::PointQuery::PointQuery()
+			PointQuery2D (const Pipeline2D *pipe, ElementID element) : PointQuery<PipelineElement2D>(pipe, element)
+			{}
+			/// Returns the value at the specified position.
+			NOISEPP_INLINE Real getValue (Real x, Real y) const
+			{
+				Cache *cache = getCache ();
+				return getElement()->getValue (x, y, cache);
+			}
+	};
+
+	/// Thread-safe single point queries on a 3D pipeline.
+	class PointQuery3D : public PointQuery<PipelineElement3D>
+	{
+		public:
+			/// @copydoc noisepp::PointQuery::PointQuery()
+			PointQuery3D (const Pipeline3D *pipe, ElementID element) : PointQuery<PipelineElement3D>(pipe, element)
+			{}
+			/// Returns the value at the specified position.
+			NOISEPP_INLINE Real getValue (Real x, Real y, Real z) const
+			{
+				Cache *cache = getCache ();
+				return getElement()->getValue (x, y, z, cache);
+			}
+	};
+};
+
+#endif // NOISEPP_POINTQUERY_H
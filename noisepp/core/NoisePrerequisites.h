@@ -41,6 +41,7 @@ namespace noisepp
 
 	typedef size_t ElementID;
 	const ElementID ELEMENTID_INVALID = (std::numeric_limits<ElementID>::max)();
+	typedef unsigned short ModuleTypeId;
 
 	class PipelineElement1D;
 	class PipelineElement2D;
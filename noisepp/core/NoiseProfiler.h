@@ -0,0 +1,93 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPP_PROFILER_H
+#define NOISEPP_PROFILER_H
+
+#include "NoisePrerequisites.h"
+
+#if NOISEPP_ENABLE_PROFILING
+
+#include "NoiseTimer.h"
+
+namespace noisepp
+{
+	/// Profiling counters of a pipeline element.
+	struct ProfileCounters
+	{
+		/// Number of values taken from the cache.
+		unsigned long hits;
+		/// Number of values calculated by the element.
+		unsigned long misses;
+		/// Number of timed evaluations.
+		unsigned long samples;
+		/// Time of the timed evaluations in seconds, including the source elements.
+		double inclusiveTime;
+		/// Time of the timed evaluations in seconds, without the timed source elements.
+		double exclusiveTime;
+
+		/// Constructor.
+		ProfileCounters () : hits(0), misses(0), samples(0), inclusiveTime(0), exclusiveTime(0)
+		{}
+		/// Adds the counters of another thread.
+		void add (const ProfileCounters &other)
+		{
+			hits += other.hits;
+			misses += other.misses;
+			samples += other.samples;
+			inclusiveTime += other.inclusiveTime;
+			exclusiveTime += other.exclusiveTime;
+		}
+		/// Returns the estimated total inclusive time of all evaluations in seconds.
+		double getEstimatedInclusiveTime () const
+		{
+			return samples ? inclusiveTime / samples * misses : 0.0;
+		}
+		/// Returns the estimated total exclusive time of all evaluations in seconds.
+		double getEstimatedExclusiveTime () const
+		{
+			return samples ? exclusiveTime / samples * misses : 0.0;
+		}
+	};
+
+	/// Timing state of the thread owning a cache.
+	struct ProfileThreadState
+	{
+		/// Set while a sampled evaluation is running, all nested evaluations are timed then.
+		bool timing;
+		/// Time spent in timed source elements of the current evaluation.
+		double childTime;
+		/// Number of elements the cache was created for.
+		size_t elementCount;
+
+		/// Constructor.
+		ProfileThreadState () : timing(false), childTime(0), elementCount(0)
+		{}
+	};
+};
+
+#endif // NOISEPP_ENABLE_PROFILING
+
+#endif // NOISEPP_PROFILER_H
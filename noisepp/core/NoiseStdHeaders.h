@@ -37,6 +37,7 @@
 #include <algorithm>
 #include <memory>
 #include <map>
+#include <set>
 #include <queue>
 #include <stdexcept>
 #include <string>
@@ -27,6 +27,7 @@
 #define NOISEPP_THREADEDPIPELINE_H
 
 #include "NoisePipeline.h"
+#include "NoiseJobTracer.h"
 
 #if NOISEPP_ENABLE_THREADS == 0
 #error To use this classes please set NOISEPP_ENABLE_THREADS to 1
@@ -53,10 +54,20 @@ namespace noisepp
 			bool mThreadsDone;
 			unsigned mWorkingThreads;
 			PipelineJobQueue mJobsDone;
+			JobTracer *mTracer;
+			JobTracer::ThreadBuffer *mTracerMain;
+			bool mPinThreads;
+			int mNextWorker;
 			void threadFunction ()
 			{
 				Cache *cache = NULL;
+				ElementID cacheSize = 0;
+				JobTracer *tracer = NULL;
+				JobTracer::ThreadBuffer *traceBuffer = NULL;
 				threadpp::Mutex::Lock lk(mMutex);
+				// pinned before the cache is created so it is allocated on the local memory node
+				if (mPinThreads)
+					threadpp::pinCurrentThread (mNextWorker++);
 				while (!mThreadsDone)
 				{
 					if (Pipeline<Element>::mJobs.empty())
@@ -66,10 +77,28 @@ namespace noisepp
 						PipelineJob *job = Pipeline<Element>::mJobs.front ();
 						Pipeline<Element>::mJobs.pop ();
 						++mWorkingThreads;
+						if (tracer != mTracer)
+						{
+							tracer = mTracer;
+							traceBuffer = tracer ? tracer->registerThread (true) : NULL;
+						}
 						lk.unlock ();
+						// the pipeline may have grown since the cache was created (jobs executed while adding modules)
+						if (cache && cacheSize != Pipeline<Element>::getElementCount())
+						{
+							Pipeline<Element>::freeCache (cache);
+							cache = NULL;
+						}
 						if (!cache)
+						{
+							cacheSize = Pipeline<Element>::getElementCount();
 							cache = Pipeline<Element>::createCache();
+						}
+						if (traceBuffer)
+							traceBuffer->record (JobTracer::EVENT_EXECUTE_BEGIN, job);
 						job->execute(cache);
+						if (traceBuffer)
+							traceBuffer->record (JobTracer::EVENT_EXECUTE_END, job);
 						lk.lock ();
 						--mWorkingThreads;
 						mJobsDone.push (job);
@@ -91,7 +120,9 @@ namespace noisepp
 		public:
 			/// Constructor.
 			/// @param numberOfThreads The number of threads
-			ThreadedPipeline (size_t numberOfThreads) : mThreadsDone(false), mWorkingThreads(0)
+			/// @param pinThreads Pins each worker thread to its own CPU (where supported), see threadpp::pinCurrentThread().
+			ThreadedPipeline (size_t numberOfThreads, bool pinThreads=false) : mThreadsDone(false), mWorkingThreads(0), mTracer(NULL), mTracerMain(NULL),
+				mPinThreads(pinThreads), mNextWorker(pinThreads ? threadpp::reservePinIndices(int(numberOfThreads)) : 0)
 			{
 				NoiseAssert (numberOfThreads > 0, numberOfThreads);
 				for (size_t i=0;i<numberOfThreads;++i)
@@ -108,13 +139,23 @@ namespace noisepp
 				while (!Pipeline<Element>::mJobs.empty() || mWorkingThreads > 0)
 				{
 					if (!Pipeline<Element>::mJobs.empty() || mWorkingThreads > 0)
+					{
+						if (mTracerMain)
+							mTracerMain->record (JobTracer::EVENT_WAIT_BEGIN, NULL);
 						mMainCond.wait(lk);
+						if (mTracerMain)
+							mTracerMain->record (JobTracer::EVENT_WAIT_END, NULL);
+					}
 					while (!mJobsDone.empty())
 					{
 						PipelineJob *job = mJobsDone.front ();
 						mJobsDone.pop ();
 						lk.unlock ();
+						if (mTracerMain)
+							mTracerMain->record (JobTracer::EVENT_FINISH_BEGIN, job);
 						job->finish ();
+						if (mTracerMain)
+							mTracerMain->record (JobTracer::EVENT_FINISH_END, job);
 						delete job;
 						lk.lock ();
 					}
@@ -125,8 +166,23 @@ namespace noisepp
 			{
 				NoiseAssert (job != NULL, job);
 				threadpp::Mutex::Lock lk(mMutex);
+				if (mTracerMain)
+					mTracerMain->record (JobTracer::EVENT_ENQUEUE, job);
 				Pipeline<Element>::mJobs.push (job);
 			}
+			/// Sets a tracer recording the job timeline, pass NULL to disable tracing.
+			/// The tracer is not owned by the pipeline. Jobs must be added and executed by one thread while tracing.
+			void setTracer (JobTracer *tracer)
+			{
+				threadpp::Mutex::Lock lk(mMutex);
+				mTracer = tracer;
+				mTracerMain = tracer ? tracer->registerThread (false) : NULL;
+			}
+			/// Returns the tracer.
+			JobTracer *getTracer () const
+			{
+				return mTracer;
+			}
 			/// Destructor.
 			virtual ~ThreadedPipeline ()
 			{
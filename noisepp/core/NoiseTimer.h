@@ -0,0 +1,68 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPP_TIMER_H
+#define NOISEPP_TIMER_H
+
+#include "NoisePrerequisites.h"
+
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+#	include <time.h>
+#	include <sys/time.h>
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#endif
+
+namespace noisepp
+{
+	/// High resolution timer used for profiling and tracing.
+	class Timer
+	{
+		public:
+			/// Returns a monotonic time stamp in seconds.
+			static NOISEPP_INLINE double getTime ()
+			{
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+#	ifdef CLOCK_MONOTONIC
+				struct timespec ts;
+				clock_gettime (CLOCK_MONOTONIC, &ts);
+				return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+#	else
+				struct timeval tv;
+				gettimeofday (&tv, NULL);
+				return double(tv.tv_sec) + double(tv.tv_usec) * 1e-6;
+#	endif
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+				LARGE_INTEGER counter, frequency;
+				QueryPerformanceCounter (&counter);
+				QueryPerformanceFrequency (&frequency);
+				return double(counter.QuadPart) / double(frequency.QuadPart);
+#endif
+			}
+	};
+};
+
+#endif // NOISEPP_TIMER_H
@@ -210,9 +210,22 @@ namespace noisepp
 			{
 				return mPerlinX.getQuality ();
 			}
+			/// @copydoc noisepp::Module::getInternalModuleCount()
+			virtual size_t getInternalModuleCount () const
+			{
+				return 3;
+			}
+			/// @copydoc noisepp::Module::getInternalModule()
+			virtual const Module *getInternalModule (size_t id) const
+			{
+				NoiseAssertRange (id, 3);
+				const Module *modules[3] = { &mPerlinX, &mPerlinY, &mPerlinZ };
+				return modules[id];
+			}
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline1D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID perlinX = mPerlinX.addToPipeline(pipe);
@@ -221,6 +234,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID perlinX = mPerlinX.addToPipeline(pipe);
@@ -230,6 +244,7 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			virtual ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				NoiseModuleCheckSourceModules;
 				ElementID first = getSourceModule(0)->addToPipeline(pipe);
 				ElementID perlinX = mPerlinX.addToPipeline(pipe);
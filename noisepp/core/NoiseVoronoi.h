@@ -229,11 +229,13 @@ namespace noisepp
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline2D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new VoronoiElement2D(mFrequency, mSeed+pipe->getSeed(), mDisplacement, mEnableDistance));
 			}
 			/// @copydoc noisepp::Module::addToPipeline()
 			ElementID addToPipeline (Pipeline3D *pipe) const
 			{
+				NoiseModuleReturnExistingElement (pipe);
 				return pipe->addElement (this, new VoronoiElement3D(mFrequency, mSeed+pipe->getSeed(), mDisplacement, mEnableDistance));
 			}
 			/// @copydoc noisepp::Module::getType()
@@ -26,5 +26,7 @@
 #include "ThreadImplementation.h"
 #include "ThreadMutex.h"
 #include "ThreadCondition.h"
+#include "ThreadAffinity.h"
+#include "ThreadLocal.h"
 
 #endif
@@ -0,0 +1,115 @@
+// Thread++ Library
+// Copyright (c) 2008 Urs C. Hanselmann
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef THREADPP_AFFINITY_H
+#define THREADPP_AFFINITY_H
+
+#include "ThreadPrerequisites.h"
+
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX
+#	include <unistd.h>
+#	if defined(__linux__)
+#		include <sched.h>
+#	endif
+#endif
+
+namespace threadpp
+{
+	/// Returns the CPUs the calling thread is allowed to run on.
+	/// Returns false if the platform doesn't support thread affinity.
+	THREADPP_INLINE bool getAllowedCPUs (std::vector<int> &cpus)
+	{
+		cpus.clear ();
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX && defined(__linux__) && defined(CPU_ISSET)
+		cpu_set_t set;
+		CPU_ZERO (&set);
+		if (sched_getaffinity(0, sizeof(set), &set) != 0)
+			return false;
+		for (int i=0;i<CPU_SETSIZE;++i)
+		{
+			if (CPU_ISSET(i, &set))
+				cpus.push_back (i);
+		}
+		return !cpus.empty();
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+		DWORD_PTR processMask, systemMask;
+		if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+			return false;
+		for (int i=0;i<int(sizeof(DWORD_PTR)*8);++i)
+		{
+			if (processMask & (DWORD_PTR(1) << i))
+				cpus.push_back (i);
+		}
+		return !cpus.empty();
+#else
+		return false;
+#endif
+	}
+	/// Reserves indices for a group of threads pinned with pinCurrentThread().
+	/// Each group in the process starts after the previous one and the process ID offsets the first group,
+	/// so thread pools and processes sharing the CPUs don't all pin their first workers to the first CPUs.
+	/// @param count The number of threads in the group.
+	/// Returns the index of the first thread.
+	THREADPP_INLINE int reservePinIndices (int count)
+	{
+		static int next = 0;
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+		const int first = InterlockedExchangeAdd (reinterpret_cast<volatile LONG*>(&next), count);
+		const int process = int(GetCurrentProcessId());
+#else
+#	if defined(__GNUC__)
+		const int first = __sync_fetch_and_add (&next, count);
+#	else
+		const int first = next;
+		next += count;
+#	endif
+		const int process = int(getpid());
+#endif
+		// keeps the index positive for the modulo in pinCurrentThread()
+		return int(((unsigned)process + (unsigned)first) & 0x7fffffff);
+	}
+	/// Pins the calling thread to one of its allowed CPUs.
+	/// @param index Index into the allowed CPUs, wraps around if there are less CPUs.
+	/// Pinning only helps if the process owns the allowed CPUs, e.g. through a cpuset. Under a CPU quota without a cpuset
+	/// (containers limited to a share of all host CPUs) the threads of other processes run on the same CPUs, so pinning
+	/// takes away the freedom of the scheduler to move the workers to idle CPUs.
+	/// Returns false if the platform doesn't support thread affinity.
+	THREADPP_INLINE bool pinCurrentThread (int index)
+	{
+		std::vector<int> cpus;
+		if (!getAllowedCPUs(cpus))
+			return false;
+		const int cpu = cpus[index % cpus.size()];
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX && defined(__linux__) && defined(CPU_ISSET)
+		cpu_set_t set;
+		CPU_ZERO (&set);
+		CPU_SET (cpu, &set);
+		return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+		return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+		return false;
+#endif
+	}
+};
+
+#endif
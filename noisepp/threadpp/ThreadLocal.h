@@ -0,0 +1,99 @@
+// Thread++ Library
+// Copyright (c) 2008 Urs C. Hanselmann
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef THREADPP_LOCAL_H
+#define THREADPP_LOCAL_H
+
+#include "ThreadPrerequisites.h"
+
+namespace threadpp
+{
+	/// Thread local pointer slot.
+	/// Each thread sees its own value, which is NULL until the thread sets it.
+	class ThreadLocal
+	{
+		public:
+			/// Called with the value of an exiting thread if it is not NULL.
+			typedef void (*Destructor)(void *);
+
+		private:
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX
+			pthread_key_t mKey;
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+			DWORD mIndex;
+#endif
+			bool mValid;
+
+			ThreadLocal (const ThreadLocal &);
+			ThreadLocal &operator= (const ThreadLocal &);
+
+		public:
+			/// Constructor.
+			/// @param destructor Function called on thread exit (not supported on Windows, where values must be cleaned up by the owner).
+			THREADPP_INLINE ThreadLocal (Destructor destructor=NULL) : mValid(true)
+			{
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX
+				pthread_key_create (&mKey, destructor);
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+				mIndex = TlsAlloc ();
+#endif
+			}
+			/// Destructor, calls destroy().
+			THREADPP_INLINE ~ThreadLocal ()
+			{
+				destroy ();
+			}
+			/// Releases the slot, the destructor function is no longer called for exiting threads.
+			/// Values of running threads are not destroyed. The slot must not be used afterwards, calling destroy() again has no effect.
+			THREADPP_INLINE void destroy ()
+			{
+				if (!mValid)
+					return;
+				mValid = false;
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX
+				pthread_key_delete (mKey);
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+				TlsFree (mIndex);
+#endif
+			}
+			/// Returns the value of the calling thread.
+			THREADPP_INLINE void *get () const
+			{
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX
+				return pthread_getspecific (mKey);
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+				return TlsGetValue (mIndex);
+#endif
+			}
+			/// Sets the value of the calling thread.
+			THREADPP_INLINE void set (void *value)
+			{
+#if THREADPP_PLATFORM == THREADPP_PLATFORM_UNIX
+				pthread_setspecific (mKey, value);
+#elif THREADPP_PLATFORM == THREADPP_PLATFORM_WINDOWS
+				TlsSetValue (mIndex, value);
+#endif
+			}
+	};
+};
+
+#endif
@@ -24,6 +24,7 @@
 //
 
 #include "NoiseBuilders.h"
+#include "NoiseGradientRenderer.h"
 #include "NoiseSystem.h"
 #include "NoisePipelineJobs.h"
 #include "NoiseMath.h"
@@ -145,7 +146,63 @@ class SeamlessPlaneLineJob2D : public PipelineJob
 		}
 };
 
-PlaneBuilder2D::PlaneBuilder2D () : mLowerBoundX(0), mLowerBoundY(0), mUpperBoundX(0), mUpperBoundY(0), mSeamless(false)
+// Builds a line and renders it to an image right away while the values are still in the CPU cache.
+class RenderLineJob2D : public PipelineJob
+{
+	private:
+		Pipeline2D *mPipe;
+		PipelineElement2D *mElement;
+		Real x, y;
+		int n;
+		Real xDelta;
+		bool seamless;
+		Real xExtent, yExtent;
+		Real yBlend;
+		Real *buffer;
+		const GradientRenderer *renderer;
+		unsigned char *pixels;
+		PixelFormat format;
+		BuilderCallback *callback;
+
+	public:
+		RenderLineJob2D (Pipeline2D *pipe, PipelineElement2D *element, Real x, Real y, int n, Real xDelta, bool seamless, Real xExtent, Real yExtent, Real yBlend,
+			Real *buffer, const GradientRenderer *renderer, unsigned char *pixels, PixelFormat format, BuilderCallback *callback) :
+			mPipe(pipe), mElement(element), x(x), y(y), n(n), xDelta(xDelta), seamless(seamless), xExtent(xExtent), yExtent(yExtent), yBlend(yBlend),
+			buffer(buffer), renderer(renderer), pixels(pixels), format(format), callback(callback)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			// uses a temporary line buffer if the values aren't stored
+			std::vector<Real> line;
+			Real *values = buffer;
+			if (!values)
+			{
+				line.resize (n);
+				values = &line[0];
+			}
+			if (seamless)
+			{
+				SeamlessPlaneLineJob2D job(mPipe, mElement, x, y, n, xDelta, xExtent, yExtent, yBlend, values, 0);
+				job.execute (cache);
+			}
+			else
+			{
+				LineJob2D job(mPipe, mElement, x, y, n, xDelta, values);
+				job.execute (cache);
+			}
+			renderer->renderLine (values, n, pixels, format);
+		}
+		void finish ()
+		{
+			if (callback)
+			{
+				callback->callback ();
+			}
+		}
+};
+
+PlaneBuilder2D::PlaneBuilder2D () : mLowerBoundX(0), mLowerBoundY(0), mUpperBoundX(0), mUpperBoundY(0), mSeamless(false), mImage(0), mRenderer(0)
 {
 }
 
@@ -156,7 +213,16 @@ void PlaneBuilder2D::build ()
 
 void PlaneBuilder2D::build (Pipeline2D *pipeline, PipelineElement2D *element)
 {
-	checkParameters ();
+	if (mImage)
+	{
+		NoiseAssert(mWidth > 0, mWidth);
+		NoiseAssert(mHeight > 0, mHeight);
+		NoiseAssert(mImage->getWidth() == mWidth && mImage->getHeight() == mHeight, mImage);
+		NoiseAssert(mRenderer != NULL, mRenderer);
+		mRenderer->prepare ();
+	}
+	else
+		checkParameters ();
 	NoiseAssert(mLowerBoundX < mUpperBoundX, (mLowerBoundX, mUpperBoundX));
 	NoiseAssert(mLowerBoundY < mUpperBoundY, (mLowerBoundY, mUpperBoundY));
 
@@ -175,7 +241,17 @@ void PlaneBuilder2D::build (Pipeline2D *pipeline, PipelineElement2D *element)
 	Real xDelta = xExtent / (Real)mWidth;
 	Real yDelta = yExtent / (Real)mHeight;
 	Real yp = mLowerBoundY;
-	if (!mSeamless)
+	if (mImage)
+	{
+		for (int y=0;y<mHeight;++y)
+		{
+			Real yBlend = Real(1) - ((yp-mLowerBoundY) / yExtent);
+			pipeline->addJob (new RenderLineJob2D(pipeline, element, mLowerBoundX, yp, mWidth, xDelta, mSeamless, xExtent, yExtent, yBlend,
+				mDest ? mDest+(y*mWidth) : 0, mRenderer, mImage->getPixelData(0, y), mImage->getFormat(), mCallback));
+			yp += yDelta;
+		}
+	}
+	else if (!mSeamless)
 	{
 		for (int y=0;y<mHeight;++y)
 		{
@@ -244,5 +320,745 @@ bool PlaneBuilder2D::isSeamless () const
 	return mSeamless;
 }
 
+void PlaneBuilder2D::setImageDestination (Image *image, GradientRenderer *renderer)
+{
+	mImage = image;
+	mRenderer = renderer;
+}
+
+class ProgressiveLineJob2D : public PipelineJob
+{
+	private:
+		Pipeline2D *mPipe;
+		PipelineElement2D *mElement;
+		Real x, y;
+		int width, height;
+		int step;
+		bool rowDone;
+		Real xDelta;
+		Real *buffer;
+		BuilderCallback *callback;
+
+	public:
+		ProgressiveLineJob2D (Pipeline2D *pipe, PipelineElement2D *element, Real x, Real y, int width, int height, int step, bool rowDone, Real xDelta, Real *buffer, BuilderCallback *callback) :
+			mPipe(pipe), mElement(element), x(x), y(y), width(width), height(height), step(step), rowDone(rowDone), xDelta(xDelta), buffer(buffer), callback(callback)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			// if the row was sampled in the last pass only every second sample is missing
+			const int first = rowDone ? step : 0;
+			const int inc = rowDone ? step*2 : step;
+			for (int i=first;i<width;i+=inc)
+			{
+				mPipe->cleanCache (cache);
+				buffer[i] = mElement->getValue(x + xDelta*i, y, cache);
+			}
+			// fills the gaps with the nearest sample
+			if (step > 1)
+			{
+				for (int i=0;i<width;i+=step)
+				{
+					const Real v = buffer[i];
+					const int end = std::min(i+step, width);
+					for (int j=i+1;j<end;++j)
+						buffer[j] = v;
+				}
+				for (int r=1;r<height;++r)
+				{
+					memcpy (buffer+r*width, buffer, sizeof(Real)*width);
+				}
+			}
+		}
+		void finish ()
+		{
+			if (callback)
+			{
+				callback->callback ();
+			}
+		}
+};
+
+ProgressivePlaneBuilder2D::ProgressivePlaneBuilder2D () : mLowerBoundX(0), mLowerBoundY(0), mUpperBoundX(0), mUpperBoundY(0), mInitialStep(8), mPassCallback(0)
+{
+}
+
+void ProgressivePlaneBuilder2D::build ()
+{
+	build(0, 0);
+}
+
+void ProgressivePlaneBuilder2D::build (Pipeline2D *pipeline, PipelineElement2D *element)
+{
+	checkParameters ();
+	NoiseAssert(mLowerBoundX < mUpperBoundX, (mLowerBoundX, mUpperBoundX));
+	NoiseAssert(mLowerBoundY < mUpperBoundY, (mLowerBoundY, mUpperBoundY));
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline2D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	Real xDelta = (mUpperBoundX - mLowerBoundX) / (Real)mWidth;
+	Real yDelta = (mUpperBoundY - mLowerBoundY) / (Real)mHeight;
+	int pass = 0;
+	for (int step=mInitialStep;step>=1;step/=2)
+	{
+		for (int y=0;y<mHeight;y+=step)
+		{
+			const bool rowDone = (step < mInitialStep && (y % (step*2)) == 0);
+			const int height = std::min(step, mHeight-y);
+			pipeline->addJob (new ProgressiveLineJob2D(pipeline, element, mLowerBoundX, mLowerBoundY + yDelta*y, mWidth, height, step, rowDone, xDelta, mDest+(y*mWidth), mCallback));
+		}
+		pipeline->executeJobs ();
+		if (mPassCallback)
+			mPassCallback->passFinished (pass, step);
+		++pass;
+	}
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int ProgressivePlaneBuilder2D::getProgressMaximum () const
+{
+	int n = 0;
+	for (int step=mInitialStep;step>=1;step/=2)
+		n += (mHeight + step - 1) / step;
+	return n;
+}
+
+void ProgressivePlaneBuilder2D::setBounds (Real lowerBoundX, Real lowerBoundY, Real upperBoundX, Real upperBoundY)
+{
+	mLowerBoundX = lowerBoundX;
+	mLowerBoundY = lowerBoundY;
+	mUpperBoundX = upperBoundX;
+	mUpperBoundY = upperBoundY;
+}
+
+Real ProgressivePlaneBuilder2D::getLowerBoundX () const
+{
+	return mLowerBoundX;
+}
+
+Real ProgressivePlaneBuilder2D::getLowerBoundY () const
+{
+	return mLowerBoundY;
+}
+
+Real ProgressivePlaneBuilder2D::getUpperBoundX () const
+{
+	return mUpperBoundX;
+}
+
+Real ProgressivePlaneBuilder2D::getUpperBoundY () const
+{
+	return mUpperBoundY;
+}
+
+void ProgressivePlaneBuilder2D::setInitialStep (int step)
+{
+	NoiseAssert(step > 0 && (step & (step-1)) == 0, step);
+	mInitialStep = step;
+}
+
+int ProgressivePlaneBuilder2D::getInitialStep () const
+{
+	return mInitialStep;
+}
+
+int ProgressivePlaneBuilder2D::getPassCount () const
+{
+	int n = 0;
+	for (int step=mInitialStep;step>=1;step/=2)
+		++n;
+	return n;
+}
+
+void ProgressivePlaneBuilder2D::setPassCallback (ProgressiveBuilderCallback *callback)
+{
+	if (mPassCallback)
+		delete mPassCallback;
+	mPassCallback = callback;
+}
+
+ProgressivePlaneBuilder2D::~ProgressivePlaneBuilder2D ()
+{
+	if (mPassCallback)
+	{
+		delete mPassCallback;
+		mPassCallback = 0;
+	}
+}
+
+class AdaptivePlaneBuilder2D::CellJob : public PipelineJob
+{
+	private:
+		Pipeline2D *mPipe;
+		PipelineElement2D *mElement;
+		AdaptivePlaneBuilder2D *builder;
+		int x0, y0;
+		Real xDelta, yDelta;
+		// local sample grid including the right and bottom border
+		std::vector<Real> samples;
+		std::vector<char> filled;
+		int stride;
+		size_t sampleCount;
+
+		Real sample (int x, int y, Cache *cache)
+		{
+			const int i = y*stride + x;
+			if (!filled[i])
+			{
+				mPipe->cleanCache (cache);
+				samples[i] = mElement->getValue(builder->mLowerBoundX + xDelta*(x0+x), builder->mLowerBoundY + yDelta*(y0+y), cache);
+				filled[i] = 1;
+				++sampleCount;
+			}
+			return samples[i];
+		}
+		static NOISEPP_INLINE void quadraticWeights (Real a, Real &w0, Real &w1, Real &w2)
+		{
+			w0 = (Real(2)*a - Real(1)) * (a - Real(1));
+			w1 = Real(4) * a * (Real(1) - a);
+			w2 = a * (Real(2)*a - Real(1));
+		}
+		void processCell (int x, int y, int s, Cache *cache)
+		{
+			const int width = builder->mWidth;
+			const int height = builder->mHeight;
+			if (x0+x >= width || y0+y >= height)
+				return;
+			Real *dest = builder->mDest;
+			const int xEnd = std::min(x0+x+s, width) - x0;
+			const int yEnd = std::min(y0+y+s, height) - y0;
+			if (s <= 4)
+			{
+				// small cells are sampled completely
+				for (int py=y;py<yEnd;++py)
+				{
+					for (int px=x;px<xEnd;++px)
+						dest[(y0+py)*width + x0+px] = sample(px, py, cache);
+				}
+				return;
+			}
+			// samples a 5x5 grid, the samples are reused by the child cells if the cell is subdivided
+			const int q = s / 4;
+			Real v[5][5];
+			for (int j=0;j<5;++j)
+			{
+				for (int i=0;i<5;++i)
+					v[j][i] = sample(x+i*q, y+j*q, cache);
+			}
+			// the interpolation uses the 3x3 samples at the even positions, the others are used to estimate the error
+			const Real tolerance = builder->mTolerance;
+			Real w[2][3];
+			quadraticWeights (Real(0.25), w[0][0], w[0][1], w[0][2]);
+			quadraticWeights (Real(0.75), w[1][0], w[1][1], w[1][2]);
+			for (int j=0;j<5;++j)
+			{
+				for (int i=(j&1)?0:1;i<5;i+=((j&1)?1:2))
+				{
+					Real r[3];
+					for (int k=0;k<3;++k)
+					{
+						if (j & 1)
+							r[k] = w[j/2][0] * v[0][k*2] + w[j/2][1] * v[2][k*2] + w[j/2][2] * v[4][k*2];
+						else
+							r[k] = v[j][k*2];
+					}
+					const Real p = (i & 1) ? (w[i/2][0] * r[0] + w[i/2][1] * r[1] + w[i/2][2] * r[2]) : r[i/2];
+					if (fabs(v[j][i] - p) > tolerance)
+					{
+						const int h = s / 2;
+						processCell (x, y, h, cache);
+						processCell (x+h, y, h, cache);
+						processCell (x, y+h, h, cache);
+						processCell (x+h, y+h, h, cache);
+						return;
+					}
+				}
+			}
+			// biquadratic interpolation of the 3x3 samples
+			const Real invS = Real(1) / Real(s);
+			for (int py=y;py<yEnd;++py)
+			{
+				Real wy0, wy1, wy2;
+				quadraticWeights (Real(py-y) * invS, wy0, wy1, wy2);
+				const Real r0 = wy0 * v[0][0] + wy1 * v[2][0] + wy2 * v[4][0];
+				const Real r1 = wy0 * v[0][2] + wy1 * v[2][2] + wy2 * v[4][2];
+				const Real r2 = wy0 * v[0][4] + wy1 * v[2][4] + wy2 * v[4][4];
+				Real *line = dest + (y0+py)*width + x0;
+				for (int px=x;px<xEnd;++px)
+				{
+					Real wx0, wx1, wx2;
+					quadraticWeights (Real(px-x) * invS, wx0, wx1, wx2);
+					line[px] = wx0 * r0 + wx1 * r1 + wx2 * r2;
+				}
+			}
+		}
+
+	public:
+		CellJob (Pipeline2D *pipe, PipelineElement2D *element, AdaptivePlaneBuilder2D *builder, int x0, int y0, Real xDelta, Real yDelta) :
+			mPipe(pipe), mElement(element), builder(builder), x0(x0), y0(y0), xDelta(xDelta), yDelta(yDelta), stride(builder->mCellSize+1), sampleCount(0)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			samples.resize (stride*stride);
+			filled.assign (stride*stride, 0);
+			processCell (0, 0, builder->mCellSize, cache);
+		}
+		void finish ()
+		{
+			builder->mSampleCount += sampleCount;
+			if (builder->mCallback)
+			{
+				builder->mCallback->callback ();
+			}
+		}
+};
+
+AdaptivePlaneBuilder2D::AdaptivePlaneBuilder2D () : mLowerBoundX(0), mLowerBoundY(0), mUpperBoundX(0), mUpperBoundY(0), mTolerance(0.001), mCellSize(32), mSampleCount(0)
+{
+}
+
+void AdaptivePlaneBuilder2D::build ()
+{
+	build(0, 0);
+}
+
+void AdaptivePlaneBuilder2D::build (Pipeline2D *pipeline, PipelineElement2D *element)
+{
+	checkParameters ();
+	NoiseAssert(mLowerBoundX < mUpperBoundX, (mLowerBoundX, mUpperBoundX));
+	NoiseAssert(mLowerBoundY < mUpperBoundY, (mLowerBoundY, mUpperBoundY));
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline2D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	mSampleCount = 0;
+	Real xDelta = (mUpperBoundX - mLowerBoundX) / (Real)mWidth;
+	Real yDelta = (mUpperBoundY - mLowerBoundY) / (Real)mHeight;
+	for (int y=0;y<mHeight;y+=mCellSize)
+	{
+		for (int x=0;x<mWidth;x+=mCellSize)
+		{
+			pipeline->addJob (new CellJob(pipeline, element, this, x, y, xDelta, yDelta));
+		}
+	}
+	pipeline->executeJobs ();
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int AdaptivePlaneBuilder2D::getProgressMaximum () const
+{
+	return ((mWidth + mCellSize - 1) / mCellSize) * ((mHeight + mCellSize - 1) / mCellSize);
+}
+
+void AdaptivePlaneBuilder2D::setBounds (Real lowerBoundX, Real lowerBoundY, Real upperBoundX, Real upperBoundY)
+{
+	mLowerBoundX = lowerBoundX;
+	mLowerBoundY = lowerBoundY;
+	mUpperBoundX = upperBoundX;
+	mUpperBoundY = upperBoundY;
+}
+
+Real AdaptivePlaneBuilder2D::getLowerBoundX () const
+{
+	return mLowerBoundX;
+}
+
+Real AdaptivePlaneBuilder2D::getLowerBoundY () const
+{
+	return mLowerBoundY;
+}
+
+Real AdaptivePlaneBuilder2D::getUpperBoundX () const
+{
+	return mUpperBoundX;
+}
+
+Real AdaptivePlaneBuilder2D::getUpperBoundY () const
+{
+	return mUpperBoundY;
+}
+
+void AdaptivePlaneBuilder2D::setTolerance (Real tolerance)
+{
+	NoiseAssert(tolerance >= 0, tolerance);
+	mTolerance = tolerance;
+}
+
+Real AdaptivePlaneBuilder2D::getTolerance () const
+{
+	return mTolerance;
+}
+
+void AdaptivePlaneBuilder2D::setCellSize (int size)
+{
+	NoiseAssert(size >= 4 && (size & (size-1)) == 0, size);
+	mCellSize = size;
+}
+
+int AdaptivePlaneBuilder2D::getCellSize () const
+{
+	return mCellSize;
+}
+
+size_t AdaptivePlaneBuilder2D::getSampleCount () const
+{
+	return mSampleCount;
+}
+
+size_t AdaptivePlaneBuilder2D::getSavedSampleCount () const
+{
+	const size_t total = size_t(mWidth) * size_t(mHeight);
+	return (mSampleCount < total) ? total - mSampleCount : 0;
+}
+
+// Builds a line on the surface of a sphere or cylinder around the y-axis.
+// The sine and cosine tables of the columns are shared between all lines.
+class CircularLineJob3D : public PipelineJob
+{
+	private:
+		Pipeline3D *mPipe;
+		PipelineElement3D *mElement;
+		const Real *cosTable;
+		const Real *sinTable;
+		Real radius, y;
+		int n;
+		Real *buffer;
+		BuilderCallback *callback;
+
+	public:
+		CircularLineJob3D (Pipeline3D *pipe, PipelineElement3D *element, const Real *cosTable, const Real *sinTable, Real radius, Real y, int n, Real *buffer, BuilderCallback *callback) :
+			mPipe(pipe), mElement(element), cosTable(cosTable), sinTable(sinTable), radius(radius), y(y), n(n), buffer(buffer), callback(callback)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			for (int i=0;i<n;++i)
+			{
+				// cleans the cache
+				mPipe->cleanCache (cache);
+				// calculates the value
+				buffer[i] = mElement->getValue(radius*cosTable[i], y, radius*sinTable[i], cache);
+			}
+		}
+		void finish ()
+		{
+			if (callback)
+			{
+				callback->callback ();
+			}
+		}
+};
+
+static const Real DEG_TO_RAD = Real(3.14159265358979323846 / 180.0);
+
+SphereBuilder3D::SphereBuilder3D () : mSouthLatBound(-90), mNorthLatBound(90), mWestLonBound(-180), mEastLonBound(180)
+{
+}
+
+void SphereBuilder3D::build ()
+{
+	build(0, 0);
+}
+
+void SphereBuilder3D::build (Pipeline3D *pipeline, PipelineElement3D *element)
+{
+	checkParameters ();
+	NoiseAssert(mSouthLatBound < mNorthLatBound, (mSouthLatBound, mNorthLatBound));
+	NoiseAssert(mWestLonBound < mEastLonBound, (mWestLonBound, mEastLonBound));
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline3D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	// the longitude tables are shared by all rows
+	std::vector<Real> cosLon(mWidth), sinLon(mWidth);
+	const Real lonDelta = (mEastLonBound - mWestLonBound) / (Real)mWidth;
+	for (int x=0;x<mWidth;++x)
+	{
+		const Real lon = (mWestLonBound + lonDelta * x) * DEG_TO_RAD;
+		cosLon[x] = cos(lon);
+		sinLon[x] = sin(lon);
+	}
+	const Real latDelta = (mNorthLatBound - mSouthLatBound) / (Real)mHeight;
+	for (int y=0;y<mHeight;++y)
+	{
+		const Real lat = (mSouthLatBound + latDelta * y) * DEG_TO_RAD;
+		pipeline->addJob (new CircularLineJob3D(pipeline, element, &cosLon[0], &sinLon[0], cos(lat), sin(lat), mWidth, mDest+(y*mWidth), mCallback));
+	}
+	pipeline->executeJobs ();
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int SphereBuilder3D::getProgressMaximum () const
+{
+	return mHeight;
+}
+
+void SphereBuilder3D::setBounds (Real southLatBound, Real northLatBound, Real westLonBound, Real eastLonBound)
+{
+	mSouthLatBound = southLatBound;
+	mNorthLatBound = northLatBound;
+	mWestLonBound = westLonBound;
+	mEastLonBound = eastLonBound;
+}
+
+Real SphereBuilder3D::getSouthLatBound () const
+{
+	return mSouthLatBound;
+}
+
+Real SphereBuilder3D::getNorthLatBound () const
+{
+	return mNorthLatBound;
+}
+
+Real SphereBuilder3D::getWestLonBound () const
+{
+	return mWestLonBound;
+}
+
+Real SphereBuilder3D::getEastLonBound () const
+{
+	return mEastLonBound;
+}
+
+CylinderBuilder3D::CylinderBuilder3D () : mLowerAngleBound(-180), mUpperAngleBound(180), mLowerHeightBound(0), mUpperHeightBound(0)
+{
+}
+
+void CylinderBuilder3D::build ()
+{
+	build(0, 0);
+}
+
+void CylinderBuilder3D::build (Pipeline3D *pipeline, PipelineElement3D *element)
+{
+	checkParameters ();
+	NoiseAssert(mLowerAngleBound < mUpperAngleBound, (mLowerAngleBound, mUpperAngleBound));
+	NoiseAssert(mLowerHeightBound < mUpperHeightBound, (mLowerHeightBound, mUpperHeightBound));
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline3D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	// the angle tables are shared by all rows
+	std::vector<Real> cosAngle(mWidth), sinAngle(mWidth);
+	const Real angleDelta = (mUpperAngleBound - mLowerAngleBound) / (Real)mWidth;
+	for (int x=0;x<mWidth;++x)
+	{
+		const Real angle = (mLowerAngleBound + angleDelta * x) * DEG_TO_RAD;
+		cosAngle[x] = cos(angle);
+		sinAngle[x] = sin(angle);
+	}
+	const Real heightDelta = (mUpperHeightBound - mLowerHeightBound) / (Real)mHeight;
+	for (int y=0;y<mHeight;++y)
+	{
+		pipeline->addJob (new CircularLineJob3D(pipeline, element, &cosAngle[0], &sinAngle[0], 1, mLowerHeightBound + heightDelta * y, mWidth, mDest+(y*mWidth), mCallback));
+	}
+	pipeline->executeJobs ();
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int CylinderBuilder3D::getProgressMaximum () const
+{
+	return mHeight;
+}
+
+void CylinderBuilder3D::setBounds (Real lowerAngleBound, Real upperAngleBound, Real lowerHeightBound, Real upperHeightBound)
+{
+	mLowerAngleBound = lowerAngleBound;
+	mUpperAngleBound = upperAngleBound;
+	mLowerHeightBound = lowerHeightBound;
+	mUpperHeightBound = upperHeightBound;
+}
+
+Real CylinderBuilder3D::getLowerAngleBound () const
+{
+	return mLowerAngleBound;
+}
+
+Real CylinderBuilder3D::getUpperAngleBound () const
+{
+	return mUpperAngleBound;
+}
+
+Real CylinderBuilder3D::getLowerHeightBound () const
+{
+	return mLowerHeightBound;
+}
+
+Real CylinderBuilder3D::getUpperHeightBound () const
+{
+	return mUpperHeightBound;
+}
+
+// Builds a line of a cube face projected onto the unit sphere.
+class CubeFaceLineJob3D : public PipelineJob
+{
+	private:
+		Pipeline3D *mPipe;
+		PipelineElement3D *mElement;
+		const Real *uTable;
+		const Real *uSqTable;
+		Real ox, oy, oz;
+		Real ux, uy, uz;
+		Real vSq;
+		int n;
+		Real *buffer;
+		BuilderCallback *callback;
+
+	public:
+		CubeFaceLineJob3D (Pipeline3D *pipe, PipelineElement3D *element, const Real *uTable, const Real *uSqTable, const Real *origin, const Real *uAxis, Real vSq, int n, Real *buffer, BuilderCallback *callback) :
+			mPipe(pipe), mElement(element), uTable(uTable), uSqTable(uSqTable), ox(origin[0]), oy(origin[1]), oz(origin[2]),
+			ux(uAxis[0]), uy(uAxis[1]), uz(uAxis[2]), vSq(vSq), n(n), buffer(buffer), callback(callback)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			const Real lenSq = Real(1) + vSq;
+			for (int i=0;i<n;++i)
+			{
+				const Real u = uTable[i];
+				const Real invLen = Real(1) / sqrt(lenSq + uSqTable[i]);
+				// cleans the cache
+				mPipe->cleanCache (cache);
+				// calculates the value
+				buffer[i] = mElement->getValue((ox + u*ux) * invLen, (oy + u*uy) * invLen, (oz + u*uz) * invLen, cache);
+			}
+		}
+		void finish ()
+		{
+			if (callback)
+			{
+				callback->callback ();
+			}
+		}
+};
+
+CubeFaceBuilder3D::CubeFaceBuilder3D () : mFace(FACE_POSITIVE_X)
+{
+}
+
+void CubeFaceBuilder3D::build ()
+{
+	build(0, 0);
+}
+
+void CubeFaceBuilder3D::build (Pipeline3D *pipeline, PipelineElement3D *element)
+{
+	// face center, direction of the u-axis and direction of the v-axis
+	static const Real faceAxes[6][3][3] =
+	{
+		{ { 1, 0, 0}, { 0, 0,-1}, { 0,-1, 0} },
+		{ {-1, 0, 0}, { 0, 0, 1}, { 0,-1, 0} },
+		{ { 0, 1, 0}, { 1, 0, 0}, { 0, 0, 1} },
+		{ { 0,-1, 0}, { 1, 0, 0}, { 0, 0,-1} },
+		{ { 0, 0, 1}, { 1, 0, 0}, { 0,-1, 0} },
+		{ { 0, 0,-1}, {-1, 0, 0}, { 0,-1, 0} }
+	};
+
+	checkParameters ();
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline3D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	const Real *center = faceAxes[mFace][0];
+	const Real *uAxis = faceAxes[mFace][1];
+	const Real *vAxis = faceAxes[mFace][2];
+	// the u tables are shared by all rows, the samples are taken at the pixel centers
+	std::vector<Real> uTable(mWidth), uSqTable(mWidth);
+	for (int x=0;x<mWidth;++x)
+	{
+		uTable[x] = (Real(2) * x + Real(1)) / (Real)mWidth - Real(1);
+		uSqTable[x] = uTable[x] * uTable[x];
+	}
+	for (int y=0;y<mHeight;++y)
+	{
+		const Real v = (Real(2) * y + Real(1)) / (Real)mHeight - Real(1);
+		Real origin[3];
+		for (int i=0;i<3;++i)
+			origin[i] = center[i] + v * vAxis[i];
+		pipeline->addJob (new CubeFaceLineJob3D(pipeline, element, &uTable[0], &uSqTable[0], origin, uAxis, v*v, mWidth, mDest+(y*mWidth), mCallback));
+	}
+	pipeline->executeJobs ();
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int CubeFaceBuilder3D::getProgressMaximum () const
+{
+	return mHeight;
+}
+
+void CubeFaceBuilder3D::setFace (Face face)
+{
+	NoiseAssert(face >= FACE_POSITIVE_X && face <= FACE_NEGATIVE_Z, face);
+	mFace = face;
+}
+
+CubeFaceBuilder3D::Face CubeFaceBuilder3D::getFace () const
+{
+	return mFace;
+}
+
 };
 };
@@ -35,6 +35,9 @@ namespace noisepp
 namespace utils
 {
 
+class GradientRenderer;
+class Image;
+
 /// Builder callback class.
 /// Overwrite the progress() function to get the current progress (ranges from 0.0 to 1.0)
 class BuilderCallback
@@ -119,6 +122,8 @@ class PlaneBuilder2D : public Builder
 		Real mLowerBoundX, mLowerBoundY;
 		Real mUpperBoundX, mUpperBoundY;
 		bool mSeamless;
+		Image *mImage;
+		GradientRenderer *mRenderer;
 
 	public:
 		/// Constructor.
@@ -148,6 +153,244 @@ class PlaneBuilder2D : public Builder
 		void setSeamless (bool v=true);
 		/// Returns if building a seamless plane is enabled.
 		bool isSeamless () const;
+		/// Renders the plane directly to an image while building.
+		/// Each line is rendered right after it has been built, so no buffer for the whole plane is needed.
+		/// The destination set by setDestination() is optional in this case, if it is set the values are stored there as well.
+		/// Pass NULL to disable rendering.
+		/// @param image The image to render to. It must have the same size as the builder.
+		/// @param renderer The renderer used to colour the values.
+		void setImageDestination (Image *image, GradientRenderer *renderer);
+};
+
+/// Callback class for the ProgressivePlaneBuilder2D.
+/// Overwrite the passFinished() function to get notified each time a refinement pass is done.
+class ProgressiveBuilderCallback
+{
+	public:
+		/// Called in the main thread after a pass has been finished.
+		/// The whole destination buffer is valid at this point, pixels which weren't sampled yet are filled with the nearest sample.
+		/// @param pass The index of the finished pass, starting with 0.
+		/// @param step The sampling distance of the finished pass in pixels (1 for the final pass).
+		virtual void passFinished (int pass, int step) = 0;
+		/// Destructor.
+		virtual ~ProgressiveBuilderCallback ()
+		{}
+};
+
+/// Builder class for a 2D plane that is refined in several passes.
+/// The first pass only samples every n-th pixel in both directions, each following pass halves the sampling distance
+/// until every pixel is sampled. Samples of the coarser passes are reused, so the total number of samples equals the
+/// one of PlaneBuilder2D. This is useful for interactive previews where a rough image is needed as soon as possible.
+class ProgressivePlaneBuilder2D : public Builder
+{
+	private:
+		Real mLowerBoundX, mLowerBoundY;
+		Real mUpperBoundX, mUpperBoundY;
+		int mInitialStep;
+		ProgressiveBuilderCallback *mPassCallback;
+
+	public:
+		/// Constructor.
+		ProgressivePlaneBuilder2D ();
+		/// Build using the specified pipeline and element.
+		void build (Pipeline2D *pipeline, PipelineElement2D *element);
+		/// @copydoc noisepp::utils::Builder::build()
+		virtual void build ();
+		/// @copydoc noisepp::utils::Builder::getProgressMaximum()
+		int getProgressMaximum () const;
+
+		/// Sets the plane bounds.
+		/// @param lowerBoundX The x-coordinate of the lower bound.
+		/// @param lowerBoundY The y-coordinate of the lower bound.
+		/// @param upperBoundX The x-coordinate of the upper bound.
+		/// @param upperBoundY The y-coordinate of the upper bound.
+		void setBounds (Real lowerBoundX, Real lowerBoundY, Real upperBoundX, Real upperBoundY);
+		/// Returns the x-coordinate of the lower bound.
+		Real getLowerBoundX () const;
+		/// Returns the y-coordinate of the lower bound.
+		Real getLowerBoundY () const;
+		/// Returns the x-coordinate of the upper bound.
+		Real getUpperBoundX () const;
+		/// Returns the y-coordinate of the upper bound.
+		Real getUpperBoundY () const;
+		/// Sets the sampling distance of the first pass in pixels (must be a power of two, default is 8).
+		void setInitialStep (int step);
+		/// Returns the sampling distance of the first pass.
+		int getInitialStep () const;
+		/// Returns the number of passes.
+		int getPassCount () const;
+		/// Sets the pass callback. The callback will be deleted by the builder.
+		void setPassCallback (ProgressiveBuilderCallback *callback);
+		/// Destructor.
+		virtual ~ProgressivePlaneBuilder2D ();
+};
+
+/// Builder class for a 2D plane using adaptive sampling.
+/// The plane is split into square cells which are recursively subdivided like a quadtree. Each cell is sampled on a 5x5 grid
+/// and filled by biquadratic interpolation of the 3x3 samples at the even grid positions. If one of the remaining samples
+/// differs from the interpolation by more than the tolerance the cell is subdivided instead (the child cells reuse the samples).
+/// Smooth areas (e.g. behind a clamp or terrace module) are thus built with only a fraction of the samples.
+/// Note that the error is only checked at the sample positions, so features smaller than a quarter of a cell may be missed.
+/// Set the tolerance to 0 to get the same output as PlaneBuilder2D.
+class AdaptivePlaneBuilder2D : public Builder
+{
+	private:
+		Real mLowerBoundX, mLowerBoundY;
+		Real mUpperBoundX, mUpperBoundY;
+		Real mTolerance;
+		int mCellSize;
+		size_t mSampleCount;
+
+		class CellJob;
+
+	public:
+		/// Constructor.
+		AdaptivePlaneBuilder2D ();
+		/// Build using the specified pipeline and element.
+		void build (Pipeline2D *pipeline, PipelineElement2D *element);
+		/// @copydoc noisepp::utils::Builder::build()
+		virtual void build ();
+		/// @copydoc noisepp::utils::Builder::getProgressMaximum()
+		int getProgressMaximum () const;
+
+		/// Sets the plane bounds.
+		/// @param lowerBoundX The x-coordinate of the lower bound.
+		/// @param lowerBoundY The y-coordinate of the lower bound.
+		/// @param upperBoundX The x-coordinate of the upper bound.
+		/// @param upperBoundY The y-coordinate of the upper bound.
+		void setBounds (Real lowerBoundX, Real lowerBoundY, Real upperBoundX, Real upperBoundY);
+		/// Returns the x-coordinate of the lower bound.
+		Real getLowerBoundX () const;
+		/// Returns the y-coordinate of the lower bound.
+		Real getLowerBoundY () const;
+		/// Returns the x-coordinate of the upper bound.
+		Real getUpperBoundX () const;
+		/// Returns the y-coordinate of the upper bound.
+		Real getUpperBoundY () const;
+		/// Sets the maximum absolute error allowed for an interpolated cell (default is 0.001).
+		void setTolerance (Real tolerance);
+		/// Returns the maximum absolute error allowed for an interpolated cell.
+		Real getTolerance () const;
+		/// Sets the size of the largest cell in pixels (must be a power of two and at least 4, default is 32).
+		void setCellSize (int size);
+		/// Returns the size of the largest cell in pixels.
+		int getCellSize () const;
+		/// Returns the number of samples taken by the last build.
+		size_t getSampleCount () const;
+		/// Returns the number of samples saved by the last build compared to sampling every pixel.
+		size_t getSavedSampleCount () const;
+};
+
+/// Builder class for a spherical (equirectangular) map.
+/// The map is built from a 3D pipeline by sampling the surface of the unit sphere.
+/// The sine and cosine values are calculated once per row and column instead of per pixel.
+class SphereBuilder3D : public Builder
+{
+	private:
+		Real mSouthLatBound, mNorthLatBound;
+		Real mWestLonBound, mEastLonBound;
+
+	public:
+		/// Constructor.
+		SphereBuilder3D ();
+		/// Build using the specified pipeline and element.
+		void build (Pipeline3D *pipeline, PipelineElement3D *element);
+		/// @copydoc noisepp::utils::Builder::build()
+		virtual void build ();
+		/// @copydoc noisepp::utils::Builder::getProgressMaximum()
+		int getProgressMaximum () const;
+
+		/// Sets the coordinate bounds in degrees.
+		/// @param southLatBound The southern latitude bound (at least -90).
+		/// @param northLatBound The northern latitude bound (at most 90).
+		/// @param westLonBound The western longitude bound.
+		/// @param eastLonBound The eastern longitude bound.
+		void setBounds (Real southLatBound, Real northLatBound, Real westLonBound, Real eastLonBound);
+		/// Returns the southern latitude bound.
+		Real getSouthLatBound () const;
+		/// Returns the northern latitude bound.
+		Real getNorthLatBound () const;
+		/// Returns the western longitude bound.
+		Real getWestLonBound () const;
+		/// Returns the eastern longitude bound.
+		Real getEastLonBound () const;
+};
+
+/// Builder class for a cylindrical map.
+/// The map is built from a 3D pipeline by sampling the surface of a cylinder with radius 1 around the y-axis.
+/// The sine and cosine values are calculated once per column instead of per pixel.
+class CylinderBuilder3D : public Builder
+{
+	private:
+		Real mLowerAngleBound, mUpperAngleBound;
+		Real mLowerHeightBound, mUpperHeightBound;
+
+	public:
+		/// Constructor.
+		CylinderBuilder3D ();
+		/// Build using the specified pipeline and element.
+		void build (Pipeline3D *pipeline, PipelineElement3D *element);
+		/// @copydoc noisepp::utils::Builder::build()
+		virtual void build ();
+		/// @copydoc noisepp::utils::Builder::getProgressMaximum()
+		int getProgressMaximum () const;
+
+		/// Sets the cylinder bounds.
+		/// @param lowerAngleBound The lower angle bound in degrees.
+		/// @param upperAngleBound The upper angle bound in degrees.
+		/// @param lowerHeightBound The lower height bound.
+		/// @param upperHeightBound The upper height bound.
+		void setBounds (Real lowerAngleBound, Real upperAngleBound, Real lowerHeightBound, Real upperHeightBound);
+		/// Returns the lower angle bound.
+		Real getLowerAngleBound () const;
+		/// Returns the upper angle bound.
+		Real getUpperAngleBound () const;
+		/// Returns the lower height bound.
+		Real getLowerHeightBound () const;
+		/// Returns the upper height bound.
+		Real getUpperHeightBound () const;
+};
+
+/// Builder class for a face of a cube map.
+/// The face is built from a 3D pipeline by projecting the cube face onto the unit sphere, so the six faces together cover
+/// the whole sphere without the distortion at the poles of a spherical map. Width and height should be the same.
+class CubeFaceBuilder3D : public Builder
+{
+	public:
+		/// The cube faces (same order as OpenGL and Direct3D cube maps).
+		enum Face
+		{
+			/// Positive x-axis.
+			FACE_POSITIVE_X=0,
+			/// Negative x-axis.
+			FACE_NEGATIVE_X=1,
+			/// Positive y-axis.
+			FACE_POSITIVE_Y=2,
+			/// Negative y-axis.
+			FACE_NEGATIVE_Y=3,
+			/// Positive z-axis.
+			FACE_POSITIVE_Z=4,
+			/// Negative z-axis.
+			FACE_NEGATIVE_Z=5
+		};
+
+	private:
+		Face mFace;
+
+	public:
+		/// Constructor.
+		CubeFaceBuilder3D ();
+		/// Build using the specified pipeline and element.
+		void build (Pipeline3D *pipeline, PipelineElement3D *element);
+		/// @copydoc noisepp::utils::Builder::build()
+		virtual void build ();
+		/// @copydoc noisepp::utils::Builder::getProgressMaximum()
+		int getProgressMaximum () const;
+
+		/// Sets the cube face to build.
+		void setFace (Face face);
+		/// Returns the cube face to build.
+		Face getFace () const;
 };
 
 };
@@ -0,0 +1,475 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseDiskTileCache.h"
+#include "NoiseMappedFile.h"
+#include "NoiseInStream.h"
+#include "NoiseOutStream.h"
+
+#include <cstdio>
+
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+#	include <sys/stat.h>
+#	include <sys/types.h>
+#	include <dirent.h>
+#	include <unistd.h>
+#	include <utime.h>
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#	include <io.h>
+#endif
+
+#define NOISE_TILE_FILE_VERSION 1
+#define NOISE_TILE_HEADER_SIZE 48
+
+namespace noisepp
+{
+namespace utils
+{
+
+static const char *TILE_EXTENSION = ".tile";
+static const char *TEMP_EXTENSION = ".tmp";
+
+static bool hasSuffix (const std::string &str, const char *suffix)
+{
+	const size_t len = strlen (suffix);
+	return str.size() > len && str.compare (str.size() - len, len, suffix) == 0;
+}
+
+struct DirectoryEntry
+{
+	std::string name;
+	size_t size;
+	long time;
+	bool operator< (const DirectoryEntry &other) const
+	{
+		if (time != other.time)
+			return time < other.time;
+		return name < other.name;
+	}
+};
+
+static bool createDirectory (const std::string &directory)
+{
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+	struct stat st;
+	if (stat (directory.c_str(), &st) == 0)
+		return S_ISDIR(st.st_mode);
+	return mkdir (directory.c_str(), 0755) == 0;
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	DWORD attributes = GetFileAttributesA (directory.c_str());
+	if (attributes != INVALID_FILE_ATTRIBUTES)
+		return (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+	return CreateDirectoryA (directory.c_str(), NULL) != 0;
+#endif
+}
+
+static void listDirectory (const std::string &directory, std::vector<DirectoryEntry> &entries)
+{
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+	DIR *dir = opendir (directory.c_str());
+	if (!dir)
+		return;
+	struct dirent *ent;
+	while ((ent = readdir(dir)) != NULL)
+	{
+		DirectoryEntry entry;
+		entry.name = ent->d_name;
+		struct stat st;
+		if (stat ((directory + "/" + entry.name).c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+			continue;
+		entry.size = (size_t)st.st_size;
+		entry.time = (long)st.st_mtime;
+		entries.push_back (entry);
+	}
+	closedir (dir);
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA ((directory + "\\*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+	do
+	{
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			continue;
+		DirectoryEntry entry;
+		entry.name = data.cFileName;
+		entry.size = (size_t)data.nFileSizeLow;
+		ULARGE_INTEGER time;
+		time.LowPart = data.ftLastWriteTime.dwLowDateTime;
+		time.HighPart = data.ftLastWriteTime.dwHighDateTime;
+		// seconds are enough for ordering
+		entry.time = (long)(time.QuadPart / 10000000);
+		entries.push_back (entry);
+	} while (FindNextFileA (find, &data));
+	FindClose (find);
+#endif
+}
+
+// writes the complete file under a temporary name and renames it, so readers never see a partial file
+static bool writeFileAtomic (const std::string &path, const std::string &tempPath, const void *data, size_t size)
+{
+	FILE *file = fopen (tempPath.c_str(), "wb");
+	if (!file)
+		return false;
+	bool success = fwrite (data, 1, size, file) == size && fflush (file) == 0;
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+	success = success && fsync (fileno(file)) == 0;
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	success = success && _commit (_fileno(file)) == 0;
+#endif
+	success = (fclose (file) == 0) && success;
+	if (success)
+	{
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+		success = rename (tempPath.c_str(), path.c_str()) == 0;
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+		success = MoveFileExA (tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#endif
+	}
+	if (!success)
+		::remove (tempPath.c_str());
+	return success;
+}
+
+DiskTileCache::DiskTileCache () : mClock(0), mTempCounter(0), mMaxSize(size_t(1024)*1024*1024), mSize(0), mHits(0), mMisses(0), mEvictions(0)
+{
+}
+
+DiskTileCache::DiskTileCache (const std::string &directory, size_t maxSize) : mClock(0), mTempCounter(0), mMaxSize(maxSize), mSize(0), mHits(0), mMisses(0), mEvictions(0)
+{
+	open (directory);
+}
+
+std::string DiskTileCache::getFilename (const TileKey &key)
+{
+	char buffer[64];
+	sprintf (buffer, "_%d_%d_%d_%d", key.lod, key.size, key.x, key.y);
+	return key.fingerprint.toString() + buffer + TILE_EXTENSION;
+}
+
+std::string DiskTileCache::getPath (const std::string &filename) const
+{
+	return mDirectory + "/" + filename;
+}
+
+void DiskTileCache::touch (const std::string &filename)
+{
+	FileMap::iterator it = mFiles.find (filename);
+	if (it == mFiles.end())
+		return;
+	mUsage.erase (it->second.stamp);
+	it->second.stamp = ++mClock;
+	mUsage.insert (std::make_pair(it->second.stamp, filename));
+}
+
+void DiskTileCache::insert (const std::string &filename, size_t size)
+{
+	FileMap::iterator it = mFiles.find (filename);
+	if (it != mFiles.end())
+	{
+		mSize -= it->second.size;
+		mUsage.erase (it->second.stamp);
+		mFiles.erase (it);
+	}
+	FileEntry entry;
+	entry.size = size;
+	entry.stamp = ++mClock;
+	mFiles.insert (std::make_pair(filename, entry));
+	mUsage.insert (std::make_pair(entry.stamp, filename));
+	mSize += size;
+}
+
+void DiskTileCache::erase (const std::string &filename)
+{
+	FileMap::iterator it = mFiles.find (filename);
+	if (it == mFiles.end())
+		return;
+	mSize -= it->second.size;
+	mUsage.erase (it->second.stamp);
+	mFiles.erase (it);
+	::remove (getPath(filename).c_str());
+}
+
+void DiskTileCache::cleanup ()
+{
+	while (mSize > mMaxSize && !mUsage.empty())
+	{
+		const std::string filename = mUsage.begin()->second;
+		erase (filename);
+		++mEvictions;
+	}
+}
+
+bool DiskTileCache::open (const std::string &directory)
+{
+	close ();
+	if (directory.empty() || !createDirectory (directory))
+		return false;
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	mDirectory = directory;
+	std::vector<DirectoryEntry> entries;
+	listDirectory (directory, entries);
+	// the oldest files get the lowest stamps
+	std::sort (entries.begin(), entries.end());
+	for (size_t i=0;i<entries.size();++i)
+	{
+		if (hasSuffix (entries[i].name, TILE_EXTENSION))
+			insert (entries[i].name, entries[i].size);
+		else if (entries[i].name.find (TEMP_EXTENSION) != std::string::npos)
+			::remove (getPath(entries[i].name).c_str());
+	}
+	cleanup ();
+	return true;
+}
+
+bool DiskTileCache::isOpen () const
+{
+	return !mDirectory.empty ();
+}
+
+void DiskTileCache::close ()
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	mDirectory.clear ();
+	mFiles.clear ();
+	mUsage.clear ();
+	mSize = 0;
+}
+
+void DiskTileCache::setMaxSize (size_t size)
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	mMaxSize = size;
+	cleanup ();
+}
+
+size_t DiskTileCache::getMaxSize () const
+{
+	return mMaxSize;
+}
+
+size_t DiskTileCache::getSize () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mSize;
+}
+
+size_t DiskTileCache::getTileCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mFiles.size ();
+}
+
+bool DiskTileCache::load (const TileKey &key, Real *dest)
+{
+	NoiseAssert (dest != NULL, dest);
+	NoiseAssert (key.size > 0, key.size);
+	const std::string filename = getFilename (key);
+	std::string path;
+	{
+#if NOISEPP_ENABLE_THREADS
+		threadpp::Mutex::Lock lk(mMutex);
+#endif
+		if (mFiles.find (filename) == mFiles.end())
+		{
+			++mMisses;
+			return false;
+		}
+		path = getPath (filename);
+	}
+
+	const size_t count = key.size * key.size;
+	MappedFile file;
+	bool valid = file.open (path) && file.getSize() == NOISE_TILE_HEADER_SIZE + count * sizeof(Real);
+	if (valid)
+	{
+		MemoryInStream stream;
+		stream.open (const_cast<char*>(reinterpret_cast<const char*>(file.getData())), file.getSize());
+		char magic[4];
+		stream.read (magic, 4);
+		const int version = stream.readInt ();
+		const int realSize = stream.readInt ();
+		TileKey fileKey;
+		fileKey.lod = stream.readInt ();
+		fileKey.size = stream.readInt ();
+		fileKey.x = stream.readInt ();
+		fileKey.y = stream.readInt ();
+		unsigned words[4];
+		stream.readArray (words, 4);
+		fileKey.fingerprint = Fingerprint(words[0], words[1], words[2], words[3]);
+		valid = memcmp (magic, "NPTC", 4) == 0 && version == NOISE_TILE_FILE_VERSION && realSize == (int)sizeof(Real) && fileKey == key;
+		if (valid)
+		{
+			stream.seek (NOISE_TILE_HEADER_SIZE);
+			stream.readArray (dest, count);
+		}
+	}
+	file.close ();
+
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	if (!valid)
+	{
+		// the file has been deleted in the meantime or is damaged
+		erase (filename);
+		++mMisses;
+		return false;
+	}
+	++mHits;
+	touch (filename);
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+	utime (path.c_str(), NULL);
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	HANDLE handle = CreateFileA (path.c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL);
+	if (handle != INVALID_HANDLE_VALUE)
+	{
+		FILETIME now;
+		GetSystemTimeAsFileTime (&now);
+		SetFileTime (handle, NULL, NULL, &now);
+		CloseHandle (handle);
+	}
+#endif
+	return true;
+}
+
+bool DiskTileCache::store (const TileKey &key, const Real *data)
+{
+	NoiseAssert (data != NULL, data);
+	NoiseAssert (key.size > 0, key.size);
+	const size_t count = key.size * key.size;
+	MemoryOutStream stream;
+	stream.reserve (NOISE_TILE_HEADER_SIZE + count * sizeof(Real));
+	stream.write ("NPTC", 4);
+	stream.writeInt (NOISE_TILE_FILE_VERSION);
+	stream.writeInt ((int)sizeof(Real));
+	stream.writeInt (key.lod);
+	stream.writeInt (key.size);
+	stream.writeInt (key.x);
+	stream.writeInt (key.y);
+	for (int i=0;i<4;++i)
+	{
+		unsigned word = key.fingerprint.getWord(i);
+		stream.write (word);
+	}
+	const char padding[NOISE_TILE_HEADER_SIZE] = {0};
+	stream.write (padding, NOISE_TILE_HEADER_SIZE - stream.tell());
+	stream.writeArray (data, count);
+
+	const std::string filename = getFilename (key);
+	std::string path, tempPath;
+	{
+#if NOISEPP_ENABLE_THREADS
+		threadpp::Mutex::Lock lk(mMutex);
+#endif
+		if (!isOpen())
+			return false;
+		path = getPath (filename);
+		char buffer[64];
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+		sprintf (buffer, "%s%lu_%lu", TEMP_EXTENSION, (unsigned long)getpid(), ++mTempCounter);
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+		sprintf (buffer, "%s%lu_%lu", TEMP_EXTENSION, (unsigned long)GetCurrentProcessId(), ++mTempCounter);
+#endif
+		tempPath = path + buffer;
+	}
+
+	if (!writeFileAtomic (path, tempPath, stream.getBuffer(), stream.getBufferSize()))
+		return false;
+
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	insert (filename, stream.getBufferSize());
+	cleanup ();
+	return true;
+}
+
+void DiskTileCache::remove (const TileKey &key)
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	erase (getFilename(key));
+}
+
+void DiskTileCache::clear ()
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	while (!mUsage.empty())
+	{
+		const std::string filename = mUsage.begin()->second;
+		erase (filename);
+	}
+}
+
+unsigned long DiskTileCache::getHitCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mHits;
+}
+
+unsigned long DiskTileCache::getMissCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mMisses;
+}
+
+unsigned long DiskTileCache::getEvictionCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mEvictions;
+}
+
+void DiskTileCache::resetStatistics ()
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	mHits = mMisses = mEvictions = 0;
+}
+
+};
+};
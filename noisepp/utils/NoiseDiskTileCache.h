@@ -0,0 +1,129 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEDISKTILECACHE_H
+#define NOISEDISKTILECACHE_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseTileCache.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// Persistent tile cache in a directory on disk.
+/// Each tile is stored in its own file named after the tile key. Files are written to a temporary file first and renamed
+/// when complete, so a crash never leaves a partially written tile behind. Tiles are read back through a memory mapping.
+/// If the files exceed the size limit, the least recently used ones are deleted. The usage order is kept in the file
+/// modification times, so it survives restarts.
+/// All functions are thread-safe. The cache can be used as second tier of a TileCache (see TileCache::setDiskCache()).
+class DiskTileCache
+{
+	private:
+		struct FileEntry
+		{
+			size_t size;
+			unsigned long stamp;
+		};
+		typedef std::map<std::string, FileEntry> FileMap;
+		typedef std::map<unsigned long, std::string> UsageMap;
+
+		std::string mDirectory;
+		FileMap mFiles;
+		// file names ordered by last use
+		UsageMap mUsage;
+		unsigned long mClock;
+		unsigned long mTempCounter;
+		size_t mMaxSize;
+		size_t mSize;
+		unsigned long mHits, mMisses, mEvictions;
+#if NOISEPP_ENABLE_THREADS
+		mutable threadpp::Mutex mMutex;
+#endif
+
+		static std::string getFilename (const TileKey &key);
+		std::string getPath (const std::string &filename) const;
+		void touch (const std::string &filename);
+		void insert (const std::string &filename, size_t size);
+		void erase (const std::string &filename);
+		void cleanup ();
+
+		DiskTileCache (const DiskTileCache &);
+		DiskTileCache &operator= (const DiskTileCache &);
+	public:
+		/// Constructor.
+		DiskTileCache ();
+		/// Constructor.
+		/// @param directory The cache directory, it is created if it doesn't exist.
+		/// @param maxSize The maximum size of all tile files in bytes.
+		DiskTileCache (const std::string &directory, size_t maxSize=size_t(1024)*1024*1024);
+		/// Opens a cache directory and scans the tiles stored in it. The directory is created if it doesn't exist.
+		/// Temporary files left behind by an interrupted write are deleted.
+		/// Returns true on success, and false otherwise.
+		bool open (const std::string &directory);
+		/// Check if a directory is open.
+		bool isOpen () const;
+		/// Closes the directory, the files are kept.
+		void close ();
+
+		/// Sets the maximum size of all tile files in bytes.
+		void setMaxSize (size_t size);
+		/// Returns the maximum size of all tile files in bytes.
+		size_t getMaxSize () const;
+		/// Returns the size of all tile files in bytes.
+		size_t getSize () const;
+		/// Returns the number of stored tiles.
+		size_t getTileCount () const;
+
+		/// Reads a tile.
+		/// @param key The tile key.
+		/// @param dest The destination, it must hold key.size*key.size values.
+		/// @return true if the tile was found.
+		bool load (const TileKey &key, Real *dest);
+		/// Stores a tile.
+		/// @param key The tile key.
+		/// @param data The tile data, key.size*key.size values.
+		/// @return true if the tile has been written.
+		bool store (const TileKey &key, const Real *data);
+		/// Deletes a tile.
+		void remove (const TileKey &key);
+		/// Deletes all tiles.
+		void clear ();
+
+		/// Returns the number of tiles found by load().
+		unsigned long getHitCount () const;
+		/// Returns the number of tiles not found by load().
+		unsigned long getMissCount () const;
+		/// Returns the number of tiles deleted to stay within the size limit.
+		unsigned long getEvictionCount () const;
+		/// Resets the hit, miss and eviction counters.
+		void resetStatistics ();
+};
+
+};
+};
+
+#endif // NOISEDISKTILECACHE_H
@@ -46,5 +46,44 @@ void EndianUtils::flipEndian (void *data, size_t size)
 #endif
 }
 
+void EndianUtils::flipEndianArray (void *data, size_t size, size_t count)
+{
+#if NOISEPP_BIG_ENDIAN
+	// the common sizes are swapped as whole words, which the compiler can vectorize
+	if (size == 2)
+	{
+		unsigned short *p = static_cast<unsigned short*>(data);
+		for (size_t i=0;i<count;++i)
+			p[i] = (unsigned short)((p[i] >> 8) | (p[i] << 8));
+	}
+	else if (size == 4)
+	{
+		unsigned *p = static_cast<unsigned*>(data);
+		for (size_t i=0;i<count;++i)
+		{
+			const unsigned v = p[i];
+			p[i] = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+		}
+	}
+	else if (size == 8)
+	{
+		unsigned *p = static_cast<unsigned*>(data);
+		for (size_t i=0;i<count;++i)
+		{
+			const unsigned lo = p[i*2];
+			const unsigned hi = p[i*2+1];
+			p[i*2] = (hi >> 24) | ((hi >> 8) & 0xff00) | ((hi << 8) & 0xff0000) | (hi << 24);
+			p[i*2+1] = (lo >> 24) | ((lo >> 8) & 0xff00) | ((lo << 8) & 0xff0000) | (lo << 24);
+		}
+	}
+	else
+	{
+		char *p = static_cast<char*>(data);
+		for (size_t i=0;i<count;++i)
+			flipEndian (p+i*size, size);
+	}
+#endif
+}
+
 };
 };
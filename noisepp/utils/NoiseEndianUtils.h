@@ -39,6 +39,11 @@ class EndianUtils
 	public:
 		/// Flips the endian mode if required.
 		static void flipEndian (void *data, size_t size);
+		/// Flips the endian mode of an array if required.
+		/// @param data The array.
+		/// @param size The size of one element.
+		/// @param count The number of elements.
+		static void flipEndianArray (void *data, size_t size, size_t count);
 };
 
 };
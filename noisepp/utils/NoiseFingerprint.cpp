@@ -0,0 +1,205 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseFingerprint.h"
+#include "NoiseOutStream.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+static inline unsigned rotl (unsigned x, int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline unsigned fmix (unsigned h)
+{
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+// MurmurHash3 (x86, 128 bit), blocks are read as little endian so the result is the same on every platform
+static void murmurHash128 (const unsigned char *data, size_t len, unsigned out[4])
+{
+	const unsigned c1 = 0x239b961bu;
+	const unsigned c2 = 0xab0e9789u;
+	const unsigned c3 = 0x38b34ae5u;
+	const unsigned c4 = 0xa1e38b93u;
+	unsigned h1 = 0, h2 = 0, h3 = 0, h4 = 0;
+	const size_t blocks = len / 16;
+	for (size_t i=0;i<blocks;++i)
+	{
+		const unsigned char *p = data + i*16;
+		unsigned k[4];
+		for (int j=0;j<4;++j)
+			k[j] = (unsigned)p[j*4] | ((unsigned)p[j*4+1] << 8) | ((unsigned)p[j*4+2] << 16) | ((unsigned)p[j*4+3] << 24);
+		k[0] *= c1; k[0] = rotl(k[0], 15); k[0] *= c2; h1 ^= k[0];
+		h1 = rotl(h1, 19); h1 += h2; h1 = h1*5 + 0x561ccd1bu;
+		k[1] *= c2; k[1] = rotl(k[1], 16); k[1] *= c3; h2 ^= k[1];
+		h2 = rotl(h2, 17); h2 += h3; h2 = h2*5 + 0x0bcaa747u;
+		k[2] *= c3; k[2] = rotl(k[2], 17); k[2] *= c4; h3 ^= k[2];
+		h3 = rotl(h3, 15); h3 += h4; h3 = h3*5 + 0x96cd1c35u;
+		k[3] *= c4; k[3] = rotl(k[3], 18); k[3] *= c1; h4 ^= k[3];
+		h4 = rotl(h4, 13); h4 += h1; h4 = h4*5 + 0x32ac3b17u;
+	}
+	const unsigned char *tail = data + blocks*16;
+	unsigned k[4] = {0, 0, 0, 0};
+	for (size_t i=len & 15;i>0;--i)
+		k[(i-1) / 4] ^= (unsigned)tail[i-1] << (((i-1) & 3) * 8);
+	if (len & 15)
+	{
+		k[3] *= c4; k[3] = rotl(k[3], 18); k[3] *= c1; h4 ^= k[3];
+		k[2] *= c3; k[2] = rotl(k[2], 17); k[2] *= c4; h3 ^= k[2];
+		k[1] *= c2; k[1] = rotl(k[1], 16); k[1] *= c3; h2 ^= k[1];
+		k[0] *= c1; k[0] = rotl(k[0], 15); k[0] *= c2; h1 ^= k[0];
+	}
+	const unsigned l = (unsigned)len;
+	h1 ^= l; h2 ^= l; h3 ^= l; h4 ^= l;
+	h1 += h2; h1 += h3; h1 += h4;
+	h2 += h1; h3 += h1; h4 += h1;
+	h1 = fmix(h1); h2 = fmix(h2); h3 = fmix(h3); h4 = fmix(h4);
+	h1 += h2; h1 += h3; h1 += h4;
+	h2 += h1; h3 += h1; h4 += h1;
+	out[0] = h1; out[1] = h2; out[2] = h3; out[3] = h4;
+}
+
+typedef std::map<const Module*, Fingerprint> FingerprintMap;
+
+static void writeFingerprint (MemoryOutStream &stream, const Fingerprint &fingerprint)
+{
+	for (int i=0;i<4;++i)
+	{
+		unsigned word = fingerprint.getWord(i);
+		stream.write (word);
+	}
+}
+
+// hashes a module from its type, its parameters and the fingerprints of its source modules (in source order)
+static Fingerprint computeModule (const Module *module, FingerprintMap &visited)
+{
+	NoiseAssert (module != NULL, module);
+	FingerprintMap::iterator it = visited.find (module);
+	if (it != visited.end())
+		return it->second;
+
+	MemoryOutStream params;
+	module->write (params);
+
+	MemoryOutStream stream;
+	stream.reserve (params.getBufferSize() + 16 + module->getSourceModuleCount() * 16);
+	unsigned short type = module->getType ();
+	stream.write (type);
+	unsigned paramSize = (unsigned)params.getBufferSize ();
+	stream.write (paramSize);
+	if (paramSize)
+		stream.write (params.getBuffer(), paramSize);
+	unsigned sourceCount = (unsigned)module->getSourceModuleCount ();
+	stream.write (sourceCount);
+	for (size_t i=0;i<module->getSourceModuleCount();++i)
+	{
+		const Module *source = module->getSourceModule (i);
+		NoiseAssert (source != NULL, source);
+		writeFingerprint (stream, computeModule (source, visited));
+	}
+
+	const Fingerprint fingerprint = Fingerprint::compute (stream.getBuffer(), stream.getBufferSize());
+	visited.insert (std::make_pair(module, fingerprint));
+	return fingerprint;
+}
+
+Fingerprint::Fingerprint ()
+{
+	mWords[0] = mWords[1] = mWords[2] = mWords[3] = 0;
+}
+
+Fingerprint::Fingerprint (unsigned a, unsigned b, unsigned c, unsigned d)
+{
+	mWords[0] = a;
+	mWords[1] = b;
+	mWords[2] = c;
+	mWords[3] = d;
+}
+
+Fingerprint Fingerprint::compute (const void *data, size_t size)
+{
+	NoiseAssert (data != NULL || size == 0, data);
+	Fingerprint fingerprint;
+	murmurHash128 (static_cast<const unsigned char*>(data), size, fingerprint.mWords);
+	return fingerprint;
+}
+
+Fingerprint Fingerprint::compute (const Module &module, int seed)
+{
+	// the map only memoizes shared source modules, the addresses are not part of the hash
+	FingerprintMap visited;
+	MemoryOutStream stream;
+	writeFingerprint (stream, computeModule (&module, visited));
+	stream.writeInt (seed);
+	return compute (stream.getBuffer(), stream.getBufferSize());
+}
+
+std::string Fingerprint::toString () const
+{
+	static const char digits[] = "0123456789abcdef";
+	std::string str(32, '0');
+	for (int i=0;i<4;++i)
+	{
+		for (int j=0;j<8;++j)
+			str[i*8+j] = digits[(mWords[i] >> (28 - j*4)) & 0xf];
+	}
+	return str;
+}
+
+bool Fingerprint::fromString (const std::string &str, Fingerprint &fingerprint)
+{
+	if (str.size() != 32)
+		return false;
+	unsigned words[4] = {0, 0, 0, 0};
+	for (int i=0;i<32;++i)
+	{
+		const char c = str[i];
+		unsigned digit;
+		if (c >= '0' && c <= '9')
+			digit = c - '0';
+		else if (c >= 'a' && c <= 'f')
+			digit = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			digit = c - 'A' + 10;
+		else
+			return false;
+		words[i / 8] = (words[i / 8] << 4) | digit;
+	}
+	fingerprint = Fingerprint(words[0], words[1], words[2], words[3]);
+	return true;
+}
+
+};
+};
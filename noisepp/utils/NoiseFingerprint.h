@@ -0,0 +1,97 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEFINGERPRINT_H
+#define NOISEFINGERPRINT_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseModule.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// 128 bit fingerprint of a module graph.
+/// The fingerprint is computed from the module types, the parameters serialized by Module::write(), the source module
+/// topology and the master seed. It does not depend on module addresses or the order the modules were created in,
+/// so it is stable across processes and can be used as a key for caches.
+class Fingerprint
+{
+	private:
+		unsigned mWords[4];
+
+	public:
+		/// Constructor, creates an empty fingerprint (all bits zero).
+		Fingerprint ();
+		/// Constructor.
+		Fingerprint (unsigned a, unsigned b, unsigned c, unsigned d);
+
+		/// Computes the fingerprint of the specified module and all its source modules.
+		/// @param module The root module.
+		/// @param seed The master seed the graph will be built with (see Pipeline::setSeed()).
+		static Fingerprint compute (const Module &module, int seed=0);
+		/// Computes the fingerprint of a memory block.
+		static Fingerprint compute (const void *data, size_t size);
+
+		/// Returns one of the four 32 bit words.
+		unsigned getWord (int index) const
+		{
+			NoiseAssertRange (index, 4);
+			return mWords[index];
+		}
+		/// Returns a 32 bit hash value, useful for hash tables.
+		unsigned getHash () const
+		{
+			return mWords[0];
+		}
+		/// Returns the fingerprint as a string of 32 hex digits.
+		std::string toString () const;
+		/// Parses a string created by toString(), returns false if the string is invalid.
+		static bool fromString (const std::string &str, Fingerprint &fingerprint);
+
+		bool operator== (const Fingerprint &other) const
+		{
+			return mWords[0] == other.mWords[0] && mWords[1] == other.mWords[1] && mWords[2] == other.mWords[2] && mWords[3] == other.mWords[3];
+		}
+		bool operator!= (const Fingerprint &other) const
+		{
+			return !(*this == other);
+		}
+		bool operator< (const Fingerprint &other) const
+		{
+			for (int i=0;i<4;++i)
+			{
+				if (mWords[i] != other.mWords[i])
+					return mWords[i] < other.mWords[i];
+			}
+			return false;
+		}
+};
+
+};
+};
+
+#endif // NOISEFINGERPRINT_H
@@ -31,7 +31,7 @@ namespace noisepp
 namespace utils
 {
 
-GradientRenderer::GradientRenderer() : mCallback(0)
+GradientRenderer::GradientRenderer() : mCallback(0), mLookupTableSize(4096), mLookupTableOffset(0), mLookupTableScale(0)
 {
 }
 
@@ -46,14 +46,13 @@ void GradientRenderer::addGradient (Real value, const ColourValue &color)
 
 void GradientRenderer::renderImage (Image &image, const Real *data, JobQueue *jobQueue)
 {
-	NoiseAssert (mGradients.size() >= 2, mGradients);
+	prepare ();
 	if (!jobQueue)
 		jobQueue = System::createOptimalJobQueue();
-	unsigned char *buffer = image.getPixelData ();
 	int width = image.getWidth();
 	for (int y=0;y<image.getHeight();++y)
 	{
-		jobQueue->addJob (new GradientRendererJob(this, width, data+(y*width), buffer+(y*width*3)));
+		jobQueue->addJob (new GradientRendererJob(this, width, data+(y*width), image.getPixelData(0, y), image.getFormat()));
 	}
 	jobQueue->executeJobs();
 	if (mCallback)
@@ -69,6 +68,52 @@ void GradientRenderer::setCallback(BuilderCallback *callback)
 	mCallback = callback;
 }
 
+void GradientRenderer::setLookupTableSize (int size)
+{
+	NoiseAssert (size >= 2, size);
+	mLookupTableSize = size;
+}
+
+int GradientRenderer::getLookupTableSize () const
+{
+	return mLookupTableSize;
+}
+
+void GradientRenderer::prepare ()
+{
+	NoiseAssert (mGradients.size() >= 2, mGradients);
+	const Real lower = mGradients.front().value;
+	const Real upper = mGradients.back().value;
+	const int last = mLookupTableSize - 1;
+	mLookupTable.resize (mLookupTableSize*4);
+	mLookupTableOffset = lower;
+	mLookupTableScale = (upper > lower) ? Real(last) / (upper - lower) : Real(0);
+	size_t n = 1;
+	unsigned char *entry = &mLookupTable[0];
+	for (int i=0;i<=last;++i)
+	{
+		const Real value = (upper > lower) ? lower + (upper - lower) * Real(i) / Real(last) : lower;
+		while (n < mGradients.size()-1 && mGradients[n].value <= value)
+			++n;
+		const Gradient &left = mGradients[n-1];
+		const Gradient &right = mGradients[n];
+		ColourValue color;
+		if (right.value > left.value)
+		{
+			float a = (float)((value - left.value) / (right.value - left.value));
+			if (a < 0.0f)
+				a = 0.0f;
+			if (a > 1.0f)
+				a = 1.0f;
+			color = left.color * (1.0f-a) + right.color * a;
+		}
+		else
+			color = right.color;
+		color.writeRGB (entry);
+		*entry++ = 255;
+	}
+}
+
 GradientRenderer::~GradientRenderer()
 {
 	if (mCallback)
@@ -78,40 +123,64 @@ GradientRenderer::~GradientRenderer()
 	}
 }
 
-GradientRenderer::GradientRendererJob::GradientRendererJob(GradientRenderer *renderer, int width, const Real *data, unsigned char *buffer) :
-	renderer(renderer), width(width), data(data), buffer(buffer)
+GradientRenderer::GradientRendererJob::GradientRendererJob(GradientRenderer *renderer, int width, const Real *data, unsigned char *buffer, PixelFormat format) :
+	renderer(renderer), width(width), data(data), buffer(buffer), format(format)
 {
 	assert (renderer);
 }
 
-void GradientRenderer::GradientRendererJob::execute ()
+void GradientRenderer::renderLine (const Real *data, int width, unsigned char *buffer, PixelFormat format) const
 {
-	size_t n;
+	assert (!mLookupTable.empty());
+	const unsigned char *table = &mLookupTable[0];
+	const Real offset = mLookupTableOffset;
+	const Real scale = mLookupTableScale;
+	const int last = (int)mLookupTable.size() / 4 - 1;
+	// grey formats are converted from RGBA in small blocks
+	const int BLOCK_SIZE = 256;
+	unsigned char block[BLOCK_SIZE*4];
+	const size_t pixelSize = Image::getPixelSize (format);
+	unsigned char *out = buffer;
 	for (int x=0;x<width;++x)
 	{
-		Real value = *data++;
-		ColourValue color = renderer->mGradients.front().color;
-		for (n=0;n<renderer->mGradients.size();++n)
+		// values below the first gradient point (and NaNs) map to the first entry
+		const Real f = (data[x] - offset) * scale;
+		int i = 0;
+		if (f >= Real(last))
+			i = last;
+		else if (f > Real(0))
+			i = (int)(f + Real(0.5));
+		const unsigned char *entry = table + i*4;
+		if (format == PF_RGB8)
+		{
+			out[0] = entry[0];
+			out[1] = entry[1];
+			out[2] = entry[2];
+			out += 3;
+		}
+		else if (format == PF_RGBA8)
 		{
-			if (renderer->mGradients[n].value > value)
-				break;
+			memcpy (out, entry, 4);
+			out += 4;
 		}
-		if (n < renderer->mGradients.size())
+		else
 		{
-			if (n > 0)
+			const int b = x % BLOCK_SIZE;
+			memcpy (block+b*4, entry, 4);
+			if (b == BLOCK_SIZE-1 || x == width-1)
 			{
-				const Gradient &left = renderer->mGradients[n-1];
-				const Gradient &right = renderer->mGradients[n];
-				const float a = (float)((value - left.value) / (right.value - left.value));
-				color = left.color * (1.0f-a) + right.color * a;
+				Image::convertFromRGBA (block, b+1, out, format);
+				out += (b+1)*pixelSize;
 			}
 		}
-		else
-			color = renderer->mGradients.back().color;
-		color.writeRGB (buffer);
 	}
 }
 
+void GradientRenderer::GradientRendererJob::execute ()
+{
+	renderer->renderLine (data, width, buffer, format);
+}
+
 void GradientRenderer::GradientRendererJob::finish ()
 {
 	if (renderer->mCallback)
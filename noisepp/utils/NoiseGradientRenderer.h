@@ -52,8 +52,22 @@ class GradientRenderer
 		/// @param data The source data.
 		/// @param jobQueue A pointer to a JobQueue. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
 		void renderImage (Image &image, const Real *data, JobQueue *jobQueue=0);
+		/// Prepares the renderer for renderLine() calls.
+		/// This is called by renderImage(), you only need it if you call renderLine() directly.
+		void prepare ();
+		/// Renders a line of data. This function is thread safe, prepare() must be called before.
+		/// @param data The source data.
+		/// @param width The number of values.
+		/// @param buffer The destination buffer.
+		/// @param format The pixel format of the destination buffer.
+		void renderLine (const Real *data, int width, unsigned char *buffer, PixelFormat format=PF_RGB8) const;
 		/// Sets a callback
 		void setCallback (BuilderCallback *callback);
+		/// Sets the number of entries of the colour lookup table (default is 4096).
+		/// The gradient is baked into the table once per renderImage() call, a bigger table gives smoother colour transitions.
+		void setLookupTableSize (int size);
+		/// Returns the number of entries of the colour lookup table.
+		int getLookupTableSize () const;
 		/// Destructor.
 		~GradientRenderer();
 	protected:
@@ -70,6 +84,11 @@ class GradientRenderer
 		typedef std::vector<Gradient> GradientVector;
 		GradientVector mGradients;
 		BuilderCallback *mCallback;
+		int mLookupTableSize;
+		/// RGBA colours.
+		std::vector<unsigned char> mLookupTable;
+		Real mLookupTableOffset;
+		Real mLookupTableScale;
 		class GradientRendererJob : public Job
 		{
 			private:
@@ -77,9 +96,10 @@ class GradientRenderer
 				int width;
 				const Real *data;
 				unsigned char *buffer;
+				PixelFormat format;
 
 			public:
-				GradientRendererJob(GradientRenderer *renderer, int width, const Real *data, unsigned char *buffer);
+				GradientRendererJob(GradientRenderer *renderer, int width, const Real *data, unsigned char *buffer, PixelFormat format);
 				void execute ();
 				void finish ();
 		};
@@ -0,0 +1,518 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseHeightfield.h"
+#include "NoiseOutStream.h"
+#include "NoiseInStream.h"
+#include "NoiseSystem.h"
+
+#define NOISE_HEIGHTFIELD_VERSION 1
+#define NOISE_HEIGHTFIELD_HEADER_SIZE 64
+#define NOISE_HEIGHTFIELD_ENTRY_SIZE 12
+// number of residuals sharing one bit width
+#define NOISE_HEIGHTFIELD_BLOCK_SIZE 32
+
+namespace noisepp
+{
+namespace utils
+{
+
+static inline unsigned readUInt32 (const unsigned char *p)
+{
+	return (unsigned)p[0] | ((unsigned)p[1] << 8) | ((unsigned)p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+// maps floats to unsigned integers with the same order, so neighbouring heights give small differences
+static inline unsigned floatToOrdered (float f)
+{
+	unsigned u;
+	memcpy (&u, &f, 4);
+	return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+static inline float orderedToFloat (unsigned u)
+{
+	u = (u & 0x80000000u) ? (u & 0x7fffffffu) : ~u;
+	float f;
+	memcpy (&f, &u, 4);
+	return f;
+}
+
+// gradient predictor (left + above - above left)
+static inline unsigned predict (const unsigned *values, int width, int x, int y)
+{
+	const unsigned *v = values + y*width + x;
+	if (x > 0 && y > 0)
+		return v[-1] + v[-width] - v[-width-1];
+	if (x > 0)
+		return v[-1];
+	if (y > 0)
+		return v[-width];
+	return 0;
+}
+
+// Bit packing codec for the prediction residuals
+class TileCodec
+{
+	public:
+		static void encode (const unsigned *values, int width, int height, std::vector<unsigned char> &out)
+		{
+			const int count = width * height;
+			unsigned block[NOISE_HEIGHTFIELD_BLOCK_SIZE];
+			for (int start=0;start<count;start+=NOISE_HEIGHTFIELD_BLOCK_SIZE)
+			{
+				const int n = (count - start) < NOISE_HEIGHTFIELD_BLOCK_SIZE ? (count - start) : NOISE_HEIGHTFIELD_BLOCK_SIZE;
+				unsigned bits = 0;
+				for (int i=0;i<n;++i)
+				{
+					const int index = start + i;
+					const unsigned r = values[index] - predict (values, width, index % width, index / width);
+					// zigzag encoding keeps small negative residuals small
+					block[i] = (r << 1) ^ (unsigned)((int)r >> 31);
+					bits |= block[i];
+				}
+				int bitWidth = 0;
+				while (bitWidth < 32 && (bits >> bitWidth))
+					++bitWidth;
+				out.push_back ((unsigned char)bitWidth);
+				unsigned buffer = 0;
+				int bufferBits = 0;
+				for (int i=0;i<n;++i)
+				{
+					// at most 16 bits at once, so the buffer never overflows
+					unsigned value = block[i];
+					int remaining = bitWidth;
+					while (remaining > 0)
+					{
+						const int chunk = remaining < 16 ? remaining : 16;
+						buffer |= (value & ((1u << chunk) - 1)) << bufferBits;
+						bufferBits += chunk;
+						value >>= chunk;
+						remaining -= chunk;
+						while (bufferBits >= 8)
+						{
+							out.push_back ((unsigned char)(buffer & 0xff));
+							buffer >>= 8;
+							bufferBits -= 8;
+						}
+					}
+				}
+				if (bufferBits > 0)
+					out.push_back ((unsigned char)(buffer & 0xff));
+			}
+		}
+
+		static void decode (const unsigned char *data, size_t size, int width, int height, unsigned *values)
+		{
+			const int count = width * height;
+			const unsigned char *end = data + size;
+			for (int start=0;start<count;start+=NOISE_HEIGHTFIELD_BLOCK_SIZE)
+			{
+				const int n = (count - start) < NOISE_HEIGHTFIELD_BLOCK_SIZE ? (count - start) : NOISE_HEIGHTFIELD_BLOCK_SIZE;
+				if (data >= end)
+					throw ReaderException ("Corrupt heightfield tile");
+				const int bitWidth = *data++;
+				if (bitWidth > 32 || data + (n * bitWidth + 7) / 8 > end)
+					throw ReaderException ("Corrupt heightfield tile");
+				unsigned buffer = 0;
+				int bufferBits = 0;
+				for (int i=0;i<n;++i)
+				{
+					unsigned z = 0;
+					int got = 0;
+					while (got < bitWidth)
+					{
+						const int chunk = (bitWidth - got) < 16 ? (bitWidth - got) : 16;
+						while (bufferBits < chunk)
+						{
+							buffer |= (unsigned)(*data++) << bufferBits;
+							bufferBits += 8;
+						}
+						z |= (buffer & ((1u << chunk) - 1)) << got;
+						buffer >>= chunk;
+						bufferBits -= chunk;
+						got += chunk;
+					}
+					const unsigned r = (z >> 1) ^ (0u - (z & 1));
+					const int index = start + i;
+					values[index] = r + predict (values, width, index % width, index / width);
+				}
+			}
+		}
+};
+
+// Quantizes and compresses one tile, the result is appended to the file in the main thread
+class TileWriteJob : public Job
+{
+	private:
+		const Real *data;
+		int stride;
+		int width, height;
+		HeightfieldFormat format;
+		Real low, high;
+		OutStream *stream;
+		unsigned char *entry;
+		std::vector<unsigned char> buffer;
+
+	public:
+		TileWriteJob (const Real *data, int stride, int width, int height, HeightfieldFormat format, Real low, Real high, OutStream *stream, unsigned char *entry) :
+			data(data), stride(stride), width(width), height(height), format(format), low(low), high(high), stream(stream), entry(entry)
+		{
+		}
+		void execute ()
+		{
+			std::vector<unsigned> values(width*height);
+			const Real scale = Real(65535) / (high - low);
+			for (int y=0;y<height;++y)
+			{
+				const Real *src = data + y*stride;
+				unsigned *dest = &values[y*width];
+				for (int x=0;x<width;++x)
+				{
+					if (format == HEIGHTFIELD_FLOAT32)
+						dest[x] = floatToOrdered ((float)src[x]);
+					else
+					{
+						Real v = (src[x] - low) * scale;
+						if (!(v > Real(0)))
+							v = Real(0);
+						else if (v > Real(65535))
+							v = Real(65535);
+						dest[x] = (unsigned)(v + Real(0.5));
+					}
+				}
+			}
+			TileCodec::encode (&values[0], width, height, buffer);
+		}
+		void finish ()
+		{
+			const size_t offset = stream->tell ();
+			const unsigned fields[3] = {(unsigned)(offset & 0xffffffffu), (unsigned)((offset >> 16) >> 16), (unsigned)buffer.size()};
+			for (int i=0;i<3;++i)
+			{
+				entry[i*4] = (unsigned char)(fields[i] & 0xff);
+				entry[i*4+1] = (unsigned char)((fields[i] >> 8) & 0xff);
+				entry[i*4+2] = (unsigned char)((fields[i] >> 16) & 0xff);
+				entry[i*4+3] = (unsigned char)(fields[i] >> 24);
+			}
+			stream->write (&buffer[0], buffer.size());
+		}
+};
+
+// Decodes one tile and copies the overlapping part to a region
+class TileReadJob : public Job
+{
+	private:
+		const HeightfieldReader *reader;
+		int level, tx, ty;
+		int x, y, width, height;
+		Real *dest;
+
+	public:
+		TileReadJob (const HeightfieldReader *reader, int level, int tx, int ty, int x, int y, int width, int height, Real *dest) :
+			reader(reader), level(level), tx(tx), ty(ty), x(x), y(y), width(width), height(height), dest(dest)
+		{
+		}
+		void execute ()
+		{
+			const int tileSize = reader->getTileSize ();
+			std::vector<Real> tile(tileSize*tileSize);
+			reader->readTile (level, tx, ty, &tile[0]);
+			const int left = tx * tileSize;
+			const int top = ty * tileSize;
+			const int x0 = x > left ? x : left;
+			const int y0 = y > top ? y : top;
+			const int x1 = (x + width) < (left + tileSize) ? (x + width) : (left + tileSize);
+			const int y1 = (y + height) < (top + tileSize) ? (y + height) : (top + tileSize);
+			for (int py=y0;py<y1;++py)
+				memcpy (dest + (py - y)*width + (x0 - x), &tile[(py - top)*tileSize + (x0 - left)], (x1 - x0)*sizeof(Real));
+		}
+};
+
+HeightfieldWriter::HeightfieldWriter () : mTileSize(256), mMipLevels(1), mFormat(HEIGHTFIELD_FLOAT32), mLow(-1.0), mHigh(1.0)
+{
+}
+
+void HeightfieldWriter::setTileSize (int size)
+{
+	NoiseAssert (size > 0, size);
+	mTileSize = size;
+}
+
+void HeightfieldWriter::setMipLevels (int levels)
+{
+	NoiseAssert (levels > 0, levels);
+	mMipLevels = levels;
+}
+
+void HeightfieldWriter::setFormat (HeightfieldFormat format)
+{
+	mFormat = format;
+}
+
+void HeightfieldWriter::setQuantizationRange (Real low, Real high)
+{
+	NoiseAssert (high > low, high);
+	mLow = low;
+	mHigh = high;
+}
+
+bool HeightfieldWriter::write (const std::string &filename, const Real *data, int width, int height, JobQueue *jobQueue)
+{
+	NoiseAssert (data != NULL, data);
+	NoiseAssert (width > 0, width);
+	NoiseAssert (height > 0, height);
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+	{
+		delete jobQueue;
+		return false;
+	}
+
+	// mip levels, each one averages 2x2 samples of the previous one
+	std::vector<std::vector<Real> > mips(mMipLevels);
+	std::vector<const Real*> levelData(mMipLevels);
+	std::vector<int> levelWidth(mMipLevels), levelHeight(mMipLevels);
+	levelData[0] = data;
+	levelWidth[0] = width;
+	levelHeight[0] = height;
+	for (int l=1;l<mMipLevels;++l)
+	{
+		const int pw = levelWidth[l-1];
+		const int ph = levelHeight[l-1];
+		const int w = (pw + 1) / 2;
+		const int h = (ph + 1) / 2;
+		const Real *src = levelData[l-1];
+		mips[l].resize (w*h);
+		for (int y=0;y<h;++y)
+		{
+			const int y0 = y*2;
+			const int y1 = (y*2+1 < ph) ? y*2+1 : y0;
+			for (int x=0;x<w;++x)
+			{
+				const int x0 = x*2;
+				const int x1 = (x*2+1 < pw) ? x*2+1 : x0;
+				mips[l][y*w+x] = (src[y0*pw+x0] + src[y0*pw+x1] + src[y1*pw+x0] + src[y1*pw+x1]) * Real(0.25);
+			}
+		}
+		levelData[l] = &mips[l][0];
+		levelWidth[l] = w;
+		levelHeight[l] = h;
+	}
+
+	unsigned tileCount = 0;
+	for (int l=0;l<mMipLevels;++l)
+		tileCount += ((levelWidth[l] + mTileSize - 1) / mTileSize) * ((levelHeight[l] + mTileSize - 1) / mTileSize);
+
+	// the header and the index are written again when all tile offsets are known
+	std::vector<unsigned char> index(tileCount * NOISE_HEIGHTFIELD_ENTRY_SIZE);
+	std::vector<unsigned char> header(NOISE_HEIGHTFIELD_HEADER_SIZE);
+	stream.write (&header[0], header.size());
+	stream.write (&index[0], index.size());
+
+	if (!jobQueue)
+		jobQueue = System::createOptimalJobQueue();
+	unsigned char *entry = &index[0];
+	for (int l=0;l<mMipLevels;++l)
+	{
+		const int w = levelWidth[l];
+		const int h = levelHeight[l];
+		for (int ty=0;ty*mTileSize<h;++ty)
+		{
+			for (int tx=0;tx*mTileSize<w;++tx)
+			{
+				const int tw = (w - tx*mTileSize) < mTileSize ? (w - tx*mTileSize) : mTileSize;
+				const int th = (h - ty*mTileSize) < mTileSize ? (h - ty*mTileSize) : mTileSize;
+				jobQueue->addJob (new TileWriteJob(levelData[l] + ty*mTileSize*w + tx*mTileSize, w, tw, th, mFormat, mLow, mHigh, &stream, entry));
+				entry += NOISE_HEIGHTFIELD_ENTRY_SIZE;
+			}
+		}
+	}
+	jobQueue->executeJobs ();
+	delete jobQueue;
+	jobQueue = 0;
+
+	stream.seek (0);
+	stream.write ("NPHF", 4);
+	unsigned version = NOISE_HEIGHTFIELD_VERSION;
+	stream.write (version);
+	unsigned w = width;
+	stream.write (w);
+	unsigned h = height;
+	stream.write (h);
+	unsigned tileSize = mTileSize;
+	stream.write (tileSize);
+	unsigned format = mFormat;
+	stream.write (format);
+	unsigned mipLevels = mMipLevels;
+	stream.write (mipLevels);
+	stream.write (tileCount);
+	stream.writeDouble (mLow);
+	stream.writeDouble (mHigh);
+	stream.write (&header[0], NOISE_HEIGHTFIELD_HEADER_SIZE - 48);
+	stream.write (&index[0], index.size());
+	stream.close ();
+	return true;
+}
+
+HeightfieldReader::HeightfieldReader () : mWidth(0), mHeight(0), mTileSize(0), mMipLevels(0), mFormat(HEIGHTFIELD_FLOAT32), mLow(0), mHigh(0)
+{
+}
+
+bool HeightfieldReader::open (const std::string &filename)
+{
+	close ();
+	if (!mFile.open (filename))
+		return false;
+	const unsigned char *data = mFile.getData ();
+	if (mFile.getSize() < NOISE_HEIGHTFIELD_HEADER_SIZE || memcmp(data, "NPHF", 4) != 0)
+		throw ReaderException ("Invalid heightfield header");
+	if (readUInt32 (data+4) != NOISE_HEIGHTFIELD_VERSION)
+		throw ReaderException ("Heightfield file has wrong version");
+	mWidth = (int)readUInt32 (data+8);
+	mHeight = (int)readUInt32 (data+12);
+	mTileSize = (int)readUInt32 (data+16);
+	mFormat = (HeightfieldFormat)readUInt32 (data+20);
+	mMipLevels = (int)readUInt32 (data+24);
+	const unsigned tileCount = readUInt32 (data+28);
+	MemoryInStream stream;
+	stream.open (const_cast<char*>(reinterpret_cast<const char*>(data)), NOISE_HEIGHTFIELD_HEADER_SIZE);
+	stream.seek (32);
+	mLow = (Real)stream.readDouble ();
+	mHigh = (Real)stream.readDouble ();
+	if (mWidth <= 0 || mHeight <= 0 || mTileSize <= 0 || mMipLevels <= 0 || mMipLevels > 32 ||
+		(mFormat != HEIGHTFIELD_FLOAT32 && mFormat != HEIGHTFIELD_INT16))
+		throw ReaderException ("Invalid heightfield header");
+	unsigned tiles = 0;
+	for (int l=0;l<mMipLevels;++l)
+	{
+		mLevelTiles.push_back (tiles);
+		tiles += getTileCountX(l) * getTileCountY(l);
+	}
+	if (tiles != tileCount || mFile.getSize() < NOISE_HEIGHTFIELD_HEADER_SIZE + (size_t)tileCount * NOISE_HEIGHTFIELD_ENTRY_SIZE)
+		throw ReaderException ("Invalid heightfield index");
+	return true;
+}
+
+void HeightfieldReader::close ()
+{
+	mFile.close ();
+	mLevelTiles.clear ();
+	mWidth = mHeight = mTileSize = mMipLevels = 0;
+}
+
+int HeightfieldReader::getWidth (int level) const
+{
+	NoiseAssertRange (level, mMipLevels);
+	int w = mWidth;
+	for (int l=0;l<level;++l)
+		w = (w + 1) / 2;
+	return w;
+}
+
+int HeightfieldReader::getHeight (int level) const
+{
+	NoiseAssertRange (level, mMipLevels);
+	int h = mHeight;
+	for (int l=0;l<level;++l)
+		h = (h + 1) / 2;
+	return h;
+}
+
+int HeightfieldReader::getTileCountX (int level) const
+{
+	return (getWidth(level) + mTileSize - 1) / mTileSize;
+}
+
+int HeightfieldReader::getTileCountY (int level) const
+{
+	return (getHeight(level) + mTileSize - 1) / mTileSize;
+}
+
+const unsigned char *HeightfieldReader::getTileData (int level, int tx, int ty, size_t &size) const
+{
+	NoiseAssert (mFile.isOpen(), mFile);
+	NoiseAssertRange (level, mMipLevels);
+	NoiseAssertRange (tx, getTileCountX(level));
+	NoiseAssertRange (ty, getTileCountY(level));
+	const unsigned tile = mLevelTiles[level] + ty * getTileCountX(level) + tx;
+	const unsigned char *entry = mFile.getData() + NOISE_HEIGHTFIELD_HEADER_SIZE + tile * NOISE_HEIGHTFIELD_ENTRY_SIZE;
+	const size_t offset = (size_t)readUInt32 (entry) | (((size_t)readUInt32 (entry+4) << 16) << 16);
+	size = readUInt32 (entry+8);
+	if (offset > mFile.getSize() || size > mFile.getSize() - offset)
+		throw ReaderException ("Invalid heightfield index");
+	return mFile.getData() + offset;
+}
+
+void HeightfieldReader::readTile (int level, int tx, int ty, Real *dest) const
+{
+	NoiseAssert (dest != NULL, dest);
+	size_t size;
+	const unsigned char *data = getTileData (level, tx, ty, size);
+	const int w = getWidth (level);
+	const int h = getHeight (level);
+	const int tw = (w - tx*mTileSize) < mTileSize ? (w - tx*mTileSize) : mTileSize;
+	const int th = (h - ty*mTileSize) < mTileSize ? (h - ty*mTileSize) : mTileSize;
+	std::vector<unsigned> values(tw*th);
+	TileCodec::decode (data, size, tw, th, &values[0]);
+	const Real scale = (mHigh - mLow) / Real(65535);
+	for (int y=0;y<th;++y)
+	{
+		const unsigned *src = &values[y*tw];
+		Real *out = dest + y*mTileSize;
+		if (mFormat == HEIGHTFIELD_FLOAT32)
+		{
+			for (int x=0;x<tw;++x)
+				out[x] = (Real)orderedToFloat (src[x]);
+		}
+		else
+		{
+			for (int x=0;x<tw;++x)
+				out[x] = mLow + Real(src[x] & 0xffff) * scale;
+		}
+	}
+}
+
+void HeightfieldReader::readRegion (int level, int x, int y, int width, int height, Real *dest, JobQueue *jobQueue) const
+{
+	NoiseAssert (dest != NULL, dest);
+	NoiseAssert (x >= 0 && width > 0 && x + width <= getWidth(level), x);
+	NoiseAssert (y >= 0 && height > 0 && y + height <= getHeight(level), y);
+	if (!jobQueue)
+		jobQueue = System::createOptimalJobQueue();
+	for (int ty=y/mTileSize;ty<=(y+height-1)/mTileSize;++ty)
+	{
+		for (int tx=x/mTileSize;tx<=(x+width-1)/mTileSize;++tx)
+		{
+			jobQueue->addJob (new TileReadJob(this, level, tx, ty, x, y, width, height, dest));
+		}
+	}
+	jobQueue->executeJobs ();
+	delete jobQueue;
+	jobQueue = 0;
+}
+
+};
+};
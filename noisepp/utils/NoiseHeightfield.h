@@ -0,0 +1,162 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEHEIGHTFIELD_H
+#define NOISEHEIGHTFIELD_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseJobQueue.h"
+#include "NoiseMappedFile.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// Sample formats of a tiled heightfield file.
+enum HeightfieldFormat
+{
+	/// 32-bit floats.
+	HEIGHTFIELD_FLOAT32,
+	/// 16-bit integers quantized over a value range.
+	HEIGHTFIELD_INT16
+};
+
+/// Writes tiled heightfield files.
+/// The heightfield is split into square tiles which are compressed independently with a lossless codec
+/// (gradient prediction and bit packing), so single tiles can be read without touching the rest of the file.
+/// Optional mip levels are created by averaging 2x2 samples.
+class HeightfieldWriter
+{
+	private:
+		int mTileSize;
+		int mMipLevels;
+		HeightfieldFormat mFormat;
+		Real mLow, mHigh;
+
+	public:
+		/// Constructor.
+		HeightfieldWriter ();
+		/// Sets the width and height of the tiles (default is 256).
+		void setTileSize (int size);
+		/// Returns the tile size.
+		int getTileSize () const
+		{
+			return mTileSize;
+		}
+		/// Sets the number of levels including the full resolution one (default is 1, no mip levels).
+		void setMipLevels (int levels);
+		/// Returns the number of levels.
+		int getMipLevels () const
+		{
+			return mMipLevels;
+		}
+		/// Sets the sample format (default is HEIGHTFIELD_FLOAT32).
+		void setFormat (HeightfieldFormat format);
+		/// Returns the sample format.
+		HeightfieldFormat getFormat () const
+		{
+			return mFormat;
+		}
+		/// Sets the value range quantized to HEIGHTFIELD_INT16 samples (default is -1 to 1).
+		void setQuantizationRange (Real low, Real high);
+		/// Writes the heightfield to the specified file.
+		/// @param filename The file name.
+		/// @param data The height data.
+		/// @param width The width of the data.
+		/// @param height The height of the data.
+		/// @param jobQueue A pointer to a JobQueue used to compress the tiles. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		/// Returns true on success, and false otherwise.
+		bool write (const std::string &filename, const Real *data, int width, int height, JobQueue *jobQueue=0);
+};
+
+/// Reads tiled heightfield files.
+/// The file is memory mapped, all read functions are thread safe.
+class HeightfieldReader
+{
+	private:
+		MappedFile mFile;
+		int mWidth, mHeight;
+		int mTileSize;
+		int mMipLevels;
+		HeightfieldFormat mFormat;
+		Real mLow, mHigh;
+		// the first tile of each level in the index
+		std::vector<unsigned> mLevelTiles;
+
+		const unsigned char *getTileData (int level, int tx, int ty, size_t &size) const;
+	public:
+		/// Constructor.
+		HeightfieldReader ();
+		/// Opens the specified file.
+		/// Returns true on success, and false otherwise.
+		bool open (const std::string &filename);
+		/// Closes the file.
+		void close ();
+		/// Returns the width of the specified level.
+		int getWidth (int level=0) const;
+		/// Returns the height of the specified level.
+		int getHeight (int level=0) const;
+		/// Returns the tile size.
+		int getTileSize () const
+		{
+			return mTileSize;
+		}
+		/// Returns the number of levels including the full resolution one.
+		int getMipLevels () const
+		{
+			return mMipLevels;
+		}
+		/// Returns the sample format.
+		HeightfieldFormat getFormat () const
+		{
+			return mFormat;
+		}
+		/// Returns the number of tiles in x direction of the specified level.
+		int getTileCountX (int level=0) const;
+		/// Returns the number of tiles in y direction of the specified level.
+		int getTileCountY (int level=0) const;
+		/// Decodes a tile.
+		/// Tiles at the right and bottom border may be smaller than the tile size, the rows of dest are always getTileSize() samples long.
+		/// @param level The level.
+		/// @param tx The tile column.
+		/// @param ty The tile row.
+		/// @param dest The destination buffer, at least getTileSize()*getTileSize() values.
+		void readTile (int level, int tx, int ty, Real *dest) const;
+		/// Reads a region of samples, decoding the tiles in parallel.
+		/// @param level The level.
+		/// @param x The left border of the region.
+		/// @param y The top border of the region.
+		/// @param width The width of the region.
+		/// @param height The height of the region.
+		/// @param dest The destination buffer, width*height values.
+		/// @param jobQueue A pointer to a JobQueue. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		void readRegion (int level, int x, int y, int width, int height, Real *dest, JobQueue *jobQueue=0) const;
+};
+
+};
+};
+
+#endif // NOISEHEIGHTFIELD_H
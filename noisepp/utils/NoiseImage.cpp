@@ -24,95 +24,191 @@
 //
 
 #include "NoiseImage.h"
-#include "NoiseOutStream.h"
+#include "NoiseImageEncoder.h"
+#include "NoiseColourValue.h"
 
 namespace noisepp
 {
 namespace utils
 {
 
-Image::Image() : mData(0), mWidth(0), mHeight(0)
+Image::Image() : mData(0), mBuffer(0), mWidth(0), mHeight(0), mFormat(PF_RGB8), mPixelSize(3), mPitch(0)
 {
 }
 
-void Image::create (int width, int height)
+void Image::create (int width, int height, PixelFormat format, size_t alignment)
 {
 	NoiseAssert (width > 0, width);
 	NoiseAssert (height > 0, height);
+	NoiseAssert (alignment > 0 && (alignment & (alignment-1)) == 0, alignment);
+	clear ();
 	mWidth = width;
 	mHeight = height;
+	mFormat = format;
+	mPixelSize = getPixelSize (format);
+	mPitch = (mWidth * mPixelSize + alignment - 1) & ~(alignment - 1);
 
-	mData = new unsigned char [mWidth*mHeight*3];
+	mBuffer = new unsigned char [mPitch*mHeight+alignment-1];
+	const size_t misalignment = reinterpret_cast<size_t>(mBuffer) & (alignment - 1);
+	mData = misalignment ? mBuffer + (alignment - misalignment) : mBuffer;
+}
+
+void Image::setExternalData (unsigned char *data, int width, int height, PixelFormat format, size_t pitch)
+{
+	NoiseAssert (data != NULL, data);
+	NoiseAssert (width > 0, width);
+	NoiseAssert (height > 0, height);
+	clear ();
+	mWidth = width;
+	mHeight = height;
+	mFormat = format;
+	mPixelSize = getPixelSize (format);
+	mPitch = pitch ? pitch : mWidth * mPixelSize;
+	NoiseAssert (mPitch >= mWidth * mPixelSize, pitch);
+	mData = data;
 }
 
 void Image::clear ()
 {
-	if (mData)
+	if (mBuffer)
 	{
-		delete[] mData;
-		mData = 0;
+		delete[] mBuffer;
+		mBuffer = 0;
 	}
+	mData = 0;
 	mWidth = 0;
 	mHeight = 0;
+	mPitch = 0;
 }
 
-bool Image::saveBMP (const char *filename)
+size_t Image::getPixelSize (PixelFormat format)
 {
-	NoiseAssert (mData != NULL, mData);
-	NoiseAssert (mWidth > 0, mWidth);
-	NoiseAssert (mHeight > 0, mHeight);
-	FileOutStream stream(filename);
-	if (!stream.isOpen())
-		return false;
-	// BMP Header
-	stream.write ("BM", 2);
-	unsigned size = 14 + 40 + mWidth * mHeight * 3;
-	stream.write (size);
-	unsigned res = 0;
-	stream.write (res);
-	unsigned offset = 54;
-	stream.write (offset);
+	switch (format)
+	{
+		case PF_RGB8:
+			return 3;
+		case PF_RGBA8:
+			return 4;
+		case PF_R8:
+			return 1;
+		case PF_R16:
+			return 2;
+		case PF_R32F:
+			return 4;
+	}
+	NoiseAssert (false, format);
+	return 0;
+}
 
-	// BMP properties
-	unsigned psize = 40;
-	stream.write (psize);
-	int w = mWidth;
-	stream.write (w);
-	int h = mHeight;
-	stream.write (h);
-	unsigned short planes = 1;
-	stream.write (planes);
-	unsigned short bpp = 24;
-	stream.write (bpp);
-	unsigned compression = 0;
-	stream.write (compression);
-	unsigned sizeImage = mWidth * mHeight * 3;
-	stream.write (sizeImage);
-	int ppm = 0;
-	stream.write (ppm);
-	stream.write (ppm);
-	unsigned clrUsed = 0;
-	stream.write (clrUsed);
-	unsigned clrImportant = 0;
-	stream.write (clrImportant);
-	assert (stream.tell() == offset);
+void Image::convertFromRGBA (const unsigned char *src, int count, unsigned char *dest, PixelFormat format)
+{
+	switch (format)
+	{
+		case PF_RGB8:
+			for (int i=0;i<count;++i)
+			{
+				*dest++ = src[0];
+				*dest++ = src[1];
+				*dest++ = src[2];
+				src += 4;
+			}
+			break;
+		case PF_RGBA8:
+			memcpy (dest, src, count*4);
+			break;
+		case PF_R8:
+			for (int i=0;i<count;++i)
+			{
+				*dest++ = (unsigned char)((src[0] * 77 + src[1] * 150 + src[2] * 29 + 128) >> 8);
+				src += 4;
+			}
+			break;
+		case PF_R16:
+			{
+				unsigned short *out = reinterpret_cast<unsigned short*>(dest);
+				for (int i=0;i<count;++i)
+				{
+					*out++ = (unsigned short)(((src[0] * 77 + src[1] * 150 + src[2] * 29 + 128) >> 8) * 257);
+					src += 4;
+				}
+			}
+			break;
+		case PF_R32F:
+			{
+				float *out = reinterpret_cast<float*>(dest);
+				for (int i=0;i<count;++i)
+				{
+					*out++ = (src[0] * 0.299f + src[1] * 0.587f + src[2] * 0.114f) / 255.0f;
+					src += 4;
+				}
+			}
+			break;
+	}
+}
 
-	for (int y=mHeight-1;y>=0;--y)
+void Image::convertToRGBA (const unsigned char *src, int count, unsigned char *dest, PixelFormat format)
+{
+	switch (format)
 	{
-		unsigned char *buffer = mData+y*mWidth*3;
-		for (int x=0;x<mWidth;++x)
-		{
-			unsigned char r = *buffer++;
-			unsigned char g = *buffer++;
-			unsigned char b = *buffer++;
-			stream.write (b);
-			stream.write (g);
-			stream.write (r);
-		}
+		case PF_RGB8:
+			for (int i=0;i<count;++i)
+			{
+				*dest++ = src[0];
+				*dest++ = src[1];
+				*dest++ = src[2];
+				*dest++ = 255;
+				src += 3;
+			}
+			break;
+		case PF_RGBA8:
+			memcpy (dest, src, count*4);
+			break;
+		case PF_R8:
+			for (int i=0;i<count;++i)
+			{
+				dest[0] = dest[1] = dest[2] = *src++;
+				dest[3] = 255;
+				dest += 4;
+			}
+			break;
+		case PF_R16:
+			{
+				const unsigned short *in = reinterpret_cast<const unsigned short*>(src);
+				for (int i=0;i<count;++i)
+				{
+					dest[0] = dest[1] = dest[2] = (unsigned char)(*in++ >> 8);
+					dest[3] = 255;
+					dest += 4;
+				}
+			}
+			break;
+		case PF_R32F:
+			{
+				const float *in = reinterpret_cast<const float*>(src);
+				for (int i=0;i<count;++i)
+				{
+					dest[0] = dest[1] = dest[2] = ColourValue::toUChar (*in++);
+					dest[3] = 255;
+					dest += 4;
+				}
+			}
+			break;
 	}
+}
+
+bool Image::saveBMP (const char *filename, JobQueue *jobQueue)
+{
+	return ImageEncoder::saveBMP (filename, *this, jobQueue);
+}
+
+bool Image::saveTGA (const char *filename, JobQueue *jobQueue)
+{
+	return ImageEncoder::saveTGA (filename, *this, jobQueue);
+}
 
-	stream.close ();
-	return true;
+bool Image::savePPM (const char *filename)
+{
+	return ImageEncoder::savePPM (filename, *this);
 }
 
 Image::~Image()
@@ -27,13 +27,32 @@
 #define NOISEIMAGE_H
 
 #include <cassert>
+#include <cstddef>
 
 namespace noisepp
 {
 namespace utils
 {
 
-/// Class representing an 24-bit image.
+class JobQueue;
+
+/// Pixel formats of an image.
+enum PixelFormat
+{
+	/// 24-bit RGB.
+	PF_RGB8,
+	/// 32-bit RGBA.
+	PF_RGBA8,
+	/// 8-bit grey.
+	PF_R8,
+	/// 16-bit grey, native byte order.
+	PF_R16,
+	/// 32-bit float grey, 0.0 to 1.0.
+	PF_R32F
+};
+
+/// Class representing an image.
+/// The default layout is packed 24-bit RGB. Other pixel formats, aligned rows and external storage are supported.
 class Image
 {
 	public:
@@ -42,7 +61,16 @@ class Image
 		/// Creates the image with the specified parameters.
 		/// @param width Width of the image.
 		/// @param height Height of the image.
-		void create (int width, int height);
+		/// @param format The pixel format.
+		/// @param alignment The alignment of the pixel data and of each row in bytes, must be a power of 2.
+		void create (int width, int height, PixelFormat format=PF_RGB8, size_t alignment=1);
+		/// Uses external memory as pixel data. The memory is not deleted by the image.
+		/// @param data The pixel data.
+		/// @param width Width of the image.
+		/// @param height Height of the image.
+		/// @param format The pixel format.
+		/// @param pitch The size of one row in bytes. Passing 0 uses packed rows.
+		void setExternalData (unsigned char *data, int width, int height, PixelFormat format=PF_RGB8, size_t pitch=0);
 		/// Clears the image data.
 		void clear ();
 
@@ -51,17 +79,17 @@ class Image
 		{
 			return mData;
 		}
-		/// Returns a pointer to the pixel data at the specified row.
-		/// @param i The row number.
+		/// Returns a pointer to the pixel data of the i-th pixel.
+		/// @param i The pixel number.
 		unsigned char *getPixelData (int i) const
 		{
 			assert (i < mWidth*mHeight);
-			return mData+i*3;
+			return getPixelData (i % mWidth, i / mWidth);
 		}
 		/// Returns a pointer to the pixel data at the specified position.
 		unsigned char *getPixelData (int x, int y) const
 		{
-			return mData+(y*mWidth+x)*3;
+			return mData+y*mPitch+x*mPixelSize;
 		}
 		/// Returns the width of the image.
 		int getWidth () const
@@ -73,14 +101,55 @@ class Image
 		{
 			return mHeight;
 		}
+		/// Returns the pixel format.
+		PixelFormat getFormat () const
+		{
+			return mFormat;
+		}
+		/// Returns the size of a pixel in bytes.
+		size_t getPixelSize () const
+		{
+			return mPixelSize;
+		}
+		/// Returns the size of a row in bytes.
+		size_t getPitch () const
+		{
+			return mPitch;
+		}
+		/// Returns the size of a pixel of the specified format in bytes.
+		static size_t getPixelSize (PixelFormat format);
+		/// Converts RGBA8 pixels to the specified format.
+		/// Grey formats store the luminance.
+		/// @param src The RGBA8 source pixels.
+		/// @param count The number of pixels.
+		/// @param dest The destination buffer.
+		/// @param format The destination format.
+		static void convertFromRGBA (const unsigned char *src, int count, unsigned char *dest, PixelFormat format);
+		/// Converts pixels of the specified format to RGBA8.
+		/// @param src The source pixels.
+		/// @param count The number of pixels.
+		/// @param dest The RGBA8 destination buffer.
+		/// @param format The source format.
+		static void convertToRGBA (const unsigned char *src, int count, unsigned char *dest, PixelFormat format);
 		/// Destructor.
 		~Image();
 		/// Writes the image to the specified bitmap file.
-		bool saveBMP (const char *filename);
+		/// @param filename The file name.
+		/// @param jobQueue A pointer to a JobQueue used to convert the rows. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		bool saveBMP (const char *filename, JobQueue *jobQueue=0);
+		/// Writes the image to the specified targa file.
+		/// @param filename The file name.
+		/// @param jobQueue A pointer to a JobQueue used to convert the rows. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		bool saveTGA (const char *filename, JobQueue *jobQueue=0);
+		/// Writes the image to the specified binary portable pixmap (PPM) file.
+		bool savePPM (const char *filename);
 	protected:
 	private:
 		unsigned char *mData;
+		unsigned char *mBuffer;
 		int mWidth, mHeight;
+		PixelFormat mFormat;
+		size_t mPixelSize, mPitch;
 };
 
 };
@@ -0,0 +1,359 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseImageEncoder.h"
+#include "NoiseImage.h"
+#include "NoiseSystem.h"
+
+#include <cstdio>
+
+namespace noisepp
+{
+namespace utils
+{
+
+// Converts one row of a block
+class EncodeRowJob : public Job
+{
+	private:
+		const RowEncoder *encoder;
+		int row;
+		unsigned char *dest;
+
+	public:
+		EncodeRowJob (const RowEncoder *encoder, int row, unsigned char *dest) :
+			encoder(encoder), row(row), dest(dest)
+		{
+		}
+		void execute ()
+		{
+			encoder->encodeRow (row, dest);
+		}
+};
+
+// Any pixel format to BGR or BGRA, optionally bottom-up and padded
+class BGREncoder : public RowEncoder
+{
+	private:
+		const Image &image;
+		bool bottomUp;
+		bool alpha;
+		size_t padding;
+
+	public:
+		BGREncoder (const Image &image, bool bottomUp, bool alpha, size_t padding) :
+			image(image), bottomUp(bottomUp), alpha(alpha), padding(padding)
+		{
+		}
+		void encodeRow (int row, unsigned char *dest) const
+		{
+			const int y = bottomUp ? image.getHeight()-1-row : row;
+			const int width = image.getWidth ();
+			const unsigned char *src = image.getPixelData (0, y);
+			size_t srcSize = 3;
+			std::vector<unsigned char> rgba;
+			if (image.getFormat() != PF_RGB8)
+			{
+				rgba.resize (width*4);
+				Image::convertToRGBA (src, width, &rgba[0], image.getFormat());
+				src = &rgba[0];
+				srcSize = 4;
+			}
+			for (int x=0;x<width;++x)
+			{
+				*dest++ = src[2];
+				*dest++ = src[1];
+				*dest++ = src[0];
+				if (alpha)
+					*dest++ = src[3];
+				src += srcSize;
+			}
+			for (size_t i=0;i<padding;++i)
+				*dest++ = 0;
+		}
+};
+
+// Any pixel format to RGB
+class RGBEncoder : public RowEncoder
+{
+	private:
+		const Image &image;
+
+	public:
+		RGBEncoder (const Image &image) : image(image)
+		{
+		}
+		void encodeRow (int row, unsigned char *dest) const
+		{
+			const int width = image.getWidth ();
+			std::vector<unsigned char> rgba(width*4);
+			Image::convertToRGBA (image.getPixelData (0, row), width, &rgba[0], image.getFormat());
+			Image::convertFromRGBA (&rgba[0], width, dest, PF_RGB8);
+		}
+};
+
+// Maps heights to 8 or 16-bit grey values
+class GreyEncoder : public RowEncoder
+{
+	private:
+		const Real *data;
+		int width;
+		Real low, scale;
+		int bits;
+
+	public:
+		GreyEncoder (const Real *data, int width, Real low, Real high, int bits) :
+			data(data), width(width), low(low), scale(Real((bits == 16) ? 65535 : 255) / (high - low)), bits(bits)
+		{
+		}
+		void encodeRow (int row, unsigned char *dest) const
+		{
+			const Real maxValue = Real((bits == 16) ? 65535 : 255);
+			const Real *src = data + row*width;
+			for (int x=0;x<width;++x)
+			{
+				Real v = (src[x] - low) * scale;
+				if (v < Real(0))
+					v = Real(0);
+				else if (v > maxValue)
+					v = maxValue;
+				const unsigned value = unsigned(v + Real(0.5));
+				if (bits == 16)
+				{
+					// PGM samples are big endian
+					*dest++ = (unsigned char)(value >> 8);
+					*dest++ = (unsigned char)(value & 0xff);
+				}
+				else
+					*dest++ = (unsigned char)value;
+			}
+		}
+};
+
+// Writes heights as floats in native byte order, bottom-up
+class FloatEncoder : public RowEncoder
+{
+	private:
+		const Real *data;
+		int width, height;
+
+	public:
+		FloatEncoder (const Real *data, int width, int height) :
+			data(data), width(width), height(height)
+		{
+		}
+		void encodeRow (int row, unsigned char *dest) const
+		{
+			const Real *src = data + (height-1-row)*width;
+			float *out = reinterpret_cast<float*>(dest);
+			for (int x=0;x<width;++x)
+				out[x] = float(src[x]);
+		}
+};
+
+const int ImageEncoder::ROW_BLOCK_SIZE;
+
+void ImageEncoder::writeRows (OutStream &stream, const RowEncoder &encoder, int rows, size_t rowSize, JobQueue *jobQueue)
+{
+	if (!jobQueue)
+		jobQueue = System::createOptimalJobQueue();
+	const int blockRows = rows < ROW_BLOCK_SIZE ? rows : ROW_BLOCK_SIZE;
+	std::vector<unsigned char> buffer(blockRows*rowSize);
+	for (int row=0;row<rows;row+=blockRows)
+	{
+		const int count = (rows - row) < blockRows ? (rows - row) : blockRows;
+		for (int i=0;i<count;++i)
+			jobQueue->addJob (new EncodeRowJob(&encoder, row+i, &buffer[i*rowSize]));
+		jobQueue->executeJobs ();
+		stream.write (&buffer[0], count*rowSize);
+	}
+	delete jobQueue;
+	jobQueue = 0;
+}
+
+bool ImageEncoder::saveBMP (const char *filename, const Image &image, JobQueue *jobQueue)
+{
+	NoiseAssert (image.getPixelData() != NULL, image);
+	const int width = image.getWidth ();
+	const int height = image.getHeight ();
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+	{
+		delete jobQueue;
+		return false;
+	}
+	// rows are padded to 4 bytes
+	const size_t rowSize = (width * 3 + 3) & ~3;
+	// BMP Header
+	stream.write ("BM", 2);
+	unsigned size = 14 + 40 + rowSize * height;
+	stream.write (size);
+	unsigned res = 0;
+	stream.write (res);
+	unsigned offset = 54;
+	stream.write (offset);
+
+	// BMP properties
+	unsigned psize = 40;
+	stream.write (psize);
+	int w = width;
+	stream.write (w);
+	int h = height;
+	stream.write (h);
+	unsigned short planes = 1;
+	stream.write (planes);
+	unsigned short bpp = 24;
+	stream.write (bpp);
+	unsigned compression = 0;
+	stream.write (compression);
+	unsigned sizeImage = rowSize * height;
+	stream.write (sizeImage);
+	int ppm = 0;
+	stream.write (ppm);
+	stream.write (ppm);
+	unsigned clrUsed = 0;
+	stream.write (clrUsed);
+	unsigned clrImportant = 0;
+	stream.write (clrImportant);
+	assert (stream.tell() == offset);
+
+	writeRows (stream, BGREncoder(image, true, false, rowSize - width*3), height, rowSize, jobQueue);
+
+	stream.close ();
+	return true;
+}
+
+bool ImageEncoder::saveTGA (const char *filename, const Image &image, JobQueue *jobQueue)
+{
+	NoiseAssert (image.getPixelData() != NULL, image);
+	NoiseAssertRange (image.getWidth(), 65536);
+	NoiseAssertRange (image.getHeight(), 65536);
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+	{
+		delete jobQueue;
+		return false;
+	}
+	// TGA header
+	unsigned char idLength = 0;
+	stream.write (idLength);
+	unsigned char colourMapType = 0;
+	stream.write (colourMapType);
+	unsigned char imageType = 2;
+	stream.write (imageType);
+	unsigned char colourMap[5] = {0, 0, 0, 0, 0};
+	stream.write (colourMap, 5);
+	unsigned short origin = 0;
+	stream.write (origin);
+	stream.write (origin);
+	unsigned short w = image.getWidth ();
+	stream.write (w);
+	unsigned short h = image.getHeight ();
+	stream.write (h);
+	// RGBA images keep their alpha channel
+	const bool alpha = (image.getFormat() == PF_RGBA8);
+	unsigned char bpp = alpha ? 32 : 24;
+	stream.write (bpp);
+	// top-left origin and the number of alpha bits
+	unsigned char descriptor = alpha ? 0x28 : 0x20;
+	stream.write (descriptor);
+	assert (stream.tell() == 18);
+
+	writeRows (stream, BGREncoder(image, false, alpha, 0), image.getHeight(), image.getWidth()*(bpp/8), jobQueue);
+
+	stream.close ();
+	return true;
+}
+
+bool ImageEncoder::savePPM (const char *filename, const Image &image)
+{
+	NoiseAssert (image.getPixelData() != NULL, image);
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+		return false;
+	char header[64];
+	const int len = sprintf (header, "P6\n%d %d\n255\n", image.getWidth(), image.getHeight());
+	stream.write (header, len);
+	const size_t rowSize = image.getWidth() * 3;
+	// the pixel layout of packed RGB images matches, no conversion needed
+	if (image.getFormat() == PF_RGB8 && image.getPitch() == rowSize)
+		stream.write (image.getPixelData(), rowSize * image.getHeight());
+	else
+		writeRows (stream, RGBEncoder(image), image.getHeight(), rowSize);
+	stream.close ();
+	return true;
+}
+
+bool ImageEncoder::savePGM (const char *filename, const Real *data, int width, int height, Real low, Real high, int bits, JobQueue *jobQueue)
+{
+	NoiseAssert (data != NULL, data);
+	NoiseAssert (width > 0, width);
+	NoiseAssert (height > 0, height);
+	NoiseAssert (high > low, high);
+	NoiseAssert (bits == 8 || bits == 16, bits);
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+	{
+		delete jobQueue;
+		return false;
+	}
+	char header[64];
+	const int len = sprintf (header, "P5\n%d %d\n%d\n", width, height, (bits == 16) ? 65535 : 255);
+	stream.write (header, len);
+
+	writeRows (stream, GreyEncoder(data, width, low, high, bits), height, width * (bits / 8), jobQueue);
+
+	stream.close ();
+	return true;
+}
+
+bool ImageEncoder::savePFM (const char *filename, const Real *data, int width, int height, JobQueue *jobQueue)
+{
+	NoiseAssert (data != NULL, data);
+	NoiseAssert (width > 0, width);
+	NoiseAssert (height > 0, height);
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+	{
+		delete jobQueue;
+		return false;
+	}
+	char header[64];
+	// a negative scale marks little endian data
+#if NOISEPP_BIG_ENDIAN
+	const int len = sprintf (header, "Pf\n%d %d\n1.0\n", width, height);
+#else
+	const int len = sprintf (header, "Pf\n%d %d\n-1.0\n", width, height);
+#endif
+	stream.write (header, len);
+
+	writeRows (stream, FloatEncoder(data, width, height), height, width * sizeof(float), jobQueue);
+
+	stream.close ();
+	return true;
+}
+
+};
+};
@@ -0,0 +1,92 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEIMAGEENCODER_H
+#define NOISEIMAGEENCODER_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseOutStream.h"
+#include "NoiseJobQueue.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+class Image;
+
+/// Converts the rows of an image into the pixel layout of a file format.
+class RowEncoder
+{
+	public:
+		/// Destructor.
+		virtual ~RowEncoder () {}
+		/// Writes the specified row to dest. This is called from several threads at once.
+		/// @param row The row number in file order.
+		/// @param dest The destination buffer, large enough for one row of the file.
+		virtual void encodeRow (int row, unsigned char *dest) const = 0;
+};
+
+/// Bulk image file encoder.
+/// The rows are converted in blocks by a job queue and each block is written with a single call.
+class ImageEncoder
+{
+	public:
+		/// Number of rows converted and written at once.
+		static const int ROW_BLOCK_SIZE = 64;
+
+		/// Writes rows to the stream.
+		/// @param stream The output stream.
+		/// @param encoder The encoder converting the rows.
+		/// @param rows The number of rows.
+		/// @param rowSize The size of one row in bytes.
+		/// @param jobQueue A pointer to a JobQueue. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		static void writeRows (OutStream &stream, const RowEncoder &encoder, int rows, size_t rowSize, JobQueue *jobQueue=0);
+
+		/// Writes the image to the specified bitmap file (24-bit BMP).
+		static bool saveBMP (const char *filename, const Image &image, JobQueue *jobQueue=0);
+		/// Writes the image to the specified targa file (uncompressed 24-bit TGA, 32-bit for RGBA images).
+		static bool saveTGA (const char *filename, const Image &image, JobQueue *jobQueue=0);
+		/// Writes the image to the specified binary portable pixmap (PPM) file.
+		static bool savePPM (const char *filename, const Image &image);
+		/// Writes height data to the specified binary portable graymap (PGM) file.
+		/// @param filename The file name.
+		/// @param data The height data.
+		/// @param width The width of the data.
+		/// @param height The height of the data.
+		/// @param low The value mapped to black.
+		/// @param high The value mapped to white.
+		/// @param bits The bit depth, 8 or 16.
+		/// @param jobQueue A pointer to a JobQueue. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		static bool savePGM (const char *filename, const Real *data, int width, int height, Real low=-1.0, Real high=1.0, int bits=8, JobQueue *jobQueue=0);
+		/// Writes height data to the specified portable floatmap (PFM) file.
+		/// The values are stored unchanged as single channel 32-bit floats.
+		static bool savePFM (const char *filename, const Real *data, int width, int height, JobQueue *jobQueue=0);
+};
+
+};
+};
+
+#endif // NOISEIMAGEENCODER_H
@@ -40,17 +40,20 @@ InStream::~InStream()
 {
 }
 
-FileInStream::FileInStream ()
+const size_t FileInStream::DEFAULT_BUFFER_SIZE;
+
+FileInStream::FileInStream () : mBuffer(DEFAULT_BUFFER_SIZE), mBufferPosition(0), mBufferFill(0)
 {
 }
 
-FileInStream::FileInStream(const std::string &filename)
+FileInStream::FileInStream(const std::string &filename, size_t bufferSize) : mBuffer(bufferSize), mBufferPosition(0), mBufferFill(0)
 {
 	open (filename);
 }
 
 bool FileInStream::open (const std::string &filename)
 {
+	mBufferPosition = mBufferFill = 0;
 	mFile.open (filename.c_str(), std::ios::binary);
 	return mFile.is_open ();
 }
@@ -62,23 +65,73 @@ bool FileInStream::isOpen ()
 
 void FileInStream::close ()
 {
+	mBufferPosition = mBufferFill = 0;
 	mFile.close ();
 }
 
-void FileInStream::read (void *buffer, size_t len)
+void FileInStream::setBufferSize (size_t size)
+{
+	// keeps the buffered data
+	if (size < mBufferFill - mBufferPosition)
+		size = mBufferFill - mBufferPosition;
+	std::vector<char> buffer(size);
+	if (mBufferFill > mBufferPosition)
+		std::memcpy (&buffer[0], &mBuffer[mBufferPosition], mBufferFill - mBufferPosition);
+	mBufferFill -= mBufferPosition;
+	mBufferPosition = 0;
+	mBuffer.swap (buffer);
+}
+
+void FileInStream::fillBuffer ()
 {
-	mFile.read ((char*)buffer, (std::streamsize)len);
+	mBufferPosition = mBufferFill = 0;
+	if (mBuffer.empty())
+		return;
+	mFile.read (&mBuffer[0], (std::streamsize)mBuffer.size());
+	mBufferFill = (size_t)mFile.gcount ();
 	if (mFile.bad())
 		throw std::runtime_error ("Unexpected EOF");
 }
 
+void FileInStream::read (void *buffer, size_t len)
+{
+	char *dest = static_cast<char*>(buffer);
+	while (len > 0)
+	{
+		size_t available = mBufferFill - mBufferPosition;
+		if (available == 0)
+		{
+			// big reads bypass the buffer
+			if (len >= mBuffer.size())
+			{
+				mFile.read (dest, (std::streamsize)len);
+				if (mFile.bad() || (size_t)mFile.gcount() != len)
+					throw std::runtime_error ("Unexpected EOF");
+				return;
+			}
+			fillBuffer ();
+			available = mBufferFill;
+			if (available == 0)
+				throw std::runtime_error ("Unexpected EOF");
+		}
+		const size_t n = (len < available) ? len : available;
+		std::memcpy (dest, &mBuffer[mBufferPosition], n);
+		mBufferPosition += n;
+		dest += n;
+		len -= n;
+	}
+}
+
 size_t FileInStream::tell ()
 {
-	return mFile.tellg ();
+	mFile.clear ();
+	return (size_t)mFile.tellg () - (mBufferFill - mBufferPosition);
 }
 
 void FileInStream::seek (size_t pos)
 {
+	mBufferPosition = mBufferFill = 0;
+	mFile.clear ();
 	mFile.seekg ((std::streamoff)pos);
 }
 
@@ -93,12 +146,18 @@ void MemoryInStream::open (char *buffer, size_t size)
 	mPosition = 0;
 }
 
-void MemoryInStream::read (void *buffer, size_t len)
+const char *MemoryInStream::readSpan (size_t len)
 {
 	if (mPosition+len > mSize)
 		throw std::runtime_error ("Unexpected EOF");
-	std::memcpy (buffer, mBuffer+mPosition, len);
+	const char *span = mBuffer+mPosition;
 	mPosition += len;
+	return span;
+}
+
+void MemoryInStream::read (void *buffer, size_t len)
+{
+	std::memcpy (buffer, readSpan (len), len);
 }
 
 size_t MemoryInStream::tell ()
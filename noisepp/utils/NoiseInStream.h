@@ -30,6 +30,7 @@
 #include <cstring>
 #include <string>
 #include <fstream>
+#include <vector>
 
 #include "NoiseEndianUtils.h"
 
@@ -61,6 +62,16 @@ class InStream
 			EndianUtils::flipEndian (&t, sizeof(T));
 		}
 
+		/// Read an array from stream and flip endian if required.
+		/// @param array The destination array.
+		/// @param count The number of elements.
+		template <class T>
+		void readArray (T *array, size_t count)
+		{
+			read (array, sizeof(T)*count);
+			EndianUtils::flipEndianArray (array, sizeof(T), count);
+		}
+
 		/// Read an integer from stream.
 		int readInt ()
 		{
@@ -80,17 +91,25 @@ class InStream
 	private:
 };
 
-/// Stream for reading from files.
+/// Buffered stream for reading from files.
 class FileInStream : public InStream
 {
 	private:
 		std::ifstream mFile;
+		std::vector<char> mBuffer;
+		size_t mBufferPosition, mBufferFill;
+
+		void fillBuffer ();
 	public:
+		/// Default size of the read buffer.
+		static const size_t DEFAULT_BUFFER_SIZE = 65536;
+
 		/// Constructor.
 		FileInStream();
 		/// Constructor.
 		/// @param filename The name of the input file.
-		FileInStream(const std::string &filename);
+		/// @param bufferSize The size of the read buffer.
+		FileInStream(const std::string &filename, size_t bufferSize=DEFAULT_BUFFER_SIZE);
 		/// Open the specified file for writing.
 		/// Returns true on success, and false otherwise.
 		bool open (const std::string &filename);
@@ -99,6 +118,27 @@ class FileInStream : public InStream
 		bool isOpen ();
 		/// Close the current file.
 		void close ();
+		/// Sets the size of the read buffer. Reads bigger than the buffer bypass it.
+		void setBufferSize (size_t size);
+		/// Returns the size of the read buffer.
+		size_t getBufferSize () const
+		{
+			return mBuffer.size();
+		}
+		/// @copydoc noisepp::utils::InStream::read(T &)
+		template <class T>
+		void read (T &t)
+		{
+			// small values are copied from the buffer directly
+			if (mBufferPosition + sizeof(T) <= mBufferFill)
+			{
+				std::memcpy (&t, &mBuffer[mBufferPosition], sizeof(T));
+				mBufferPosition += sizeof(T);
+			}
+			else
+				read (&t, sizeof(T));
+			EndianUtils::flipEndian (&t, sizeof(T));
+		}
 		/// @copydoc noisepp::utils::InStream::read(void *, size_t)
 		virtual void read (void *buffer, size_t len);
 		/// @copydoc noisepp::utils::InStream::tell()
@@ -130,6 +170,16 @@ class MemoryInStream : public InStream
 		{
 			return mSize;
 		}
+		/// Returns a pointer to the next len bytes in the buffer and skips them.
+		/// Nothing is copied and the endian mode is not changed.
+		const char *readSpan (size_t len);
+		/// @copydoc noisepp::utils::InStream::read(T &)
+		template <class T>
+		void read (T &t)
+		{
+			std::memcpy (&t, readSpan (sizeof(T)), sizeof(T));
+			EndianUtils::flipEndian (&t, sizeof(T));
+		}
 		/// @copydoc noisepp::utils::InStream::read(void *, size_t)
 		virtual void read (void *buffer, size_t len);
 		/// @copydoc noisepp::utils::InStream::tell()
@@ -62,7 +62,11 @@ JobQueue::~JobQueue ()
 #if NOISEPP_ENABLE_THREADS
 void ThreadedJobQueue::threadFunction ()
 {
+	JobTracer *tracer = NULL;
+	JobTracer::ThreadBuffer *traceBuffer = NULL;
 	threadpp::Mutex::Lock lk(mMutex);
+	if (mPinThreads)
+		threadpp::pinCurrentThread (mNextWorker++);
 	while (!mThreadsDone)
 	{
 		if (mJobs.empty())
@@ -72,8 +76,17 @@ void ThreadedJobQueue::threadFunction ()
 			Job *job = mJobs.front ();
 			mJobs.pop ();
 			++mWorkingThreads;
+			if (tracer != mTracer)
+			{
+				tracer = mTracer;
+				traceBuffer = tracer ? tracer->registerThread (true) : NULL;
+			}
 			lk.unlock ();
+			if (traceBuffer)
+				traceBuffer->record (JobTracer::EVENT_EXECUTE_BEGIN, job);
 			job->execute();
+			if (traceBuffer)
+				traceBuffer->record (JobTracer::EVENT_EXECUTE_END, job);
 			lk.lock ();
 			--mWorkingThreads;
 			mJobsDone.push (job);
@@ -88,7 +101,8 @@ void *ThreadedJobQueue::threadEntry (void *queue)
 	return NULL;
 }
 
-ThreadedJobQueue::ThreadedJobQueue (size_t numberOfThreads) : mThreadsDone(false), mWorkingThreads(0)
+ThreadedJobQueue::ThreadedJobQueue (size_t numberOfThreads, bool pinThreads) : mThreadsDone(false), mWorkingThreads(0), mTracer(NULL), mTracerMain(NULL),
+	mPinThreads(pinThreads), mNextWorker(pinThreads ? threadpp::reservePinIndices(int(numberOfThreads)) : 0)
 {
 	NoiseAssert (numberOfThreads > 0, numberOfThreads);
 	for (size_t i=0;i<numberOfThreads;++i)
@@ -104,13 +118,23 @@ void ThreadedJobQueue::executeJobs ()
 	while (!mJobs.empty() || mWorkingThreads > 0)
 	{
 		if (!mJobs.empty() || mWorkingThreads > 0)
+		{
+			if (mTracerMain)
+				mTracerMain->record (JobTracer::EVENT_WAIT_BEGIN, NULL);
 			mMainCond.wait(lk);
+			if (mTracerMain)
+				mTracerMain->record (JobTracer::EVENT_WAIT_END, NULL);
+		}
 		while (!mJobsDone.empty())
 		{
 			Job *job = mJobsDone.front ();
 			mJobsDone.pop ();
 			lk.unlock ();
+			if (mTracerMain)
+				mTracerMain->record (JobTracer::EVENT_FINISH_BEGIN, job);
 			job->finish ();
+			if (mTracerMain)
+				mTracerMain->record (JobTracer::EVENT_FINISH_END, job);
 			delete job;
 			lk.lock ();
 		}
@@ -121,9 +145,18 @@ void ThreadedJobQueue::addJob (Job *job)
 {
 	NoiseAssert (job != NULL, job);
 	threadpp::Mutex::Lock lk(mMutex);
+	if (mTracerMain)
+		mTracerMain->record (JobTracer::EVENT_ENQUEUE, job);
 	mJobs.push (job);
 }
 
+void ThreadedJobQueue::setTracer (JobTracer *tracer)
+{
+	threadpp::Mutex::Lock lk(mMutex);
+	mTracer = tracer;
+	mTracerMain = tracer ? tracer->registerThread (false) : NULL;
+}
+
 ThreadedJobQueue::~ThreadedJobQueue ()
 {
 	mThreadsDone = true;
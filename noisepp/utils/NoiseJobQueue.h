@@ -27,6 +27,7 @@
 #define NOISEJOBQUEUE_H
 
 #include "NoisePrerequisites.h"
+#include "NoiseJobTracer.h"
 
 namespace noisepp
 {
@@ -80,16 +81,31 @@ class ThreadedJobQueue : public JobQueue
 		bool mThreadsDone;
 		unsigned mWorkingThreads;
 
+		JobTracer *mTracer;
+		JobTracer::ThreadBuffer *mTracerMain;
+
+		bool mPinThreads;
+		int mNextWorker;
+
 		void threadFunction ();
 		static void *threadEntry (void *queue);
 	public:
 		/// Constructor.
 		/// @param numberOfThreads The number of threads
-		ThreadedJobQueue (size_t numberOfThreads);
+		/// @param pinThreads Pins each worker thread to its own CPU (where supported), see threadpp::pinCurrentThread().
+		ThreadedJobQueue (size_t numberOfThreads, bool pinThreads=false);
 		/// @copydoc noisepp::utils::JobQueue::executeJobs()
 		virtual void executeJobs ();
 		/// @copydoc noisepp::utils::JobQueue::addJob()
 		virtual void addJob (Job *job);
+		/// Sets a tracer recording the job timeline, pass NULL to disable tracing.
+		/// The tracer is not owned by the queue. Jobs must be added and executed by one thread while tracing.
+		void setTracer (JobTracer *tracer);
+		/// Returns the tracer.
+		JobTracer *getTracer () const
+		{
+			return mTracer;
+		}
 		/// Destructor.
 		virtual ~ThreadedJobQueue ();
 };
@@ -0,0 +1,220 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseLightRenderer.h"
+#include "NoiseSystem.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+LightRenderer::LightRenderer() : mAzimuth(45), mElevation(45), mContrast(1), mBrightness(1), mAmbient(0), mLightColour(1.0f, 1.0f, 1.0f), mWrap(false), mCallback(0),
+	mIntensityX(0), mIntensityY(0), mIntensityO(0)
+{
+}
+
+void LightRenderer::setLightAzimuth (Real azimuth)
+{
+	mAzimuth = azimuth;
+}
+
+Real LightRenderer::getLightAzimuth () const
+{
+	return mAzimuth;
+}
+
+void LightRenderer::setLightElevation (Real elevation)
+{
+	mElevation = elevation;
+}
+
+Real LightRenderer::getLightElevation () const
+{
+	return mElevation;
+}
+
+void LightRenderer::setLightContrast (Real contrast)
+{
+	NoiseAssert (contrast > 0, contrast);
+	mContrast = contrast;
+}
+
+Real LightRenderer::getLightContrast () const
+{
+	return mContrast;
+}
+
+void LightRenderer::setLightBrightness (Real brightness)
+{
+	mBrightness = brightness;
+}
+
+Real LightRenderer::getLightBrightness () const
+{
+	return mBrightness;
+}
+
+void LightRenderer::setAmbient (Real ambient)
+{
+	mAmbient = ambient;
+}
+
+Real LightRenderer::getAmbient () const
+{
+	return mAmbient;
+}
+
+void LightRenderer::setLightColour (const ColourValue &colour)
+{
+	mLightColour = colour;
+}
+
+const ColourValue &LightRenderer::getLightColour () const
+{
+	return mLightColour;
+}
+
+void LightRenderer::setWrap (bool v)
+{
+	mWrap = v;
+}
+
+bool LightRenderer::isWrap () const
+{
+	return mWrap;
+}
+
+void LightRenderer::renderImage (Image &image, const Real *data, GradientRenderer *gradients, JobQueue *jobQueue)
+{
+	if (gradients)
+		gradients->prepare ();
+
+	// the light direction is the same for all pixels
+	const Real degToRad = Real(3.14159265358979323846 / 180.0);
+	const Real sqrt2 = Real(1.41421356237309504880);
+	const Real cosAzimuth = cos(mAzimuth * degToRad);
+	const Real sinAzimuth = sin(mAzimuth * degToRad);
+	const Real cosElevation = cos(mElevation * degToRad);
+	const Real sinElevation = sin(mElevation * degToRad);
+	mIntensityO = sqrt2 * sinElevation / Real(2);
+	mIntensityX = (Real(1) - mIntensityO) * mContrast * sqrt2 * cosElevation * cosAzimuth;
+	mIntensityY = (Real(1) - mIntensityO) * mContrast * sqrt2 * cosElevation * sinAzimuth;
+
+	if (!jobQueue)
+		jobQueue = System::createOptimalJobQueue();
+	const int width = image.getWidth();
+	const int height = image.getHeight();
+	for (int y=0;y<height;++y)
+	{
+		// the rows above and below are the one pixel border of each line
+		int down = y - 1;
+		int up = y + 1;
+		if (down < 0)
+			down = mWrap ? height - 1 : 0;
+		if (up >= height)
+			up = mWrap ? 0 : height - 1;
+		jobQueue->addJob (new LightRendererJob(this, gradients, width, data+(y*width), data+(down*width), data+(up*width), image.getPixelData(0, y), image.getFormat()));
+	}
+	jobQueue->executeJobs();
+	if (mCallback)
+		mCallback->reset ();
+	delete jobQueue;
+	jobQueue = 0;
+}
+
+void LightRenderer::setCallback(BuilderCallback *callback)
+{
+	if (mCallback)
+		delete mCallback;
+	mCallback = callback;
+}
+
+LightRenderer::~LightRenderer()
+{
+	if (mCallback)
+	{
+		delete mCallback;
+		mCallback = 0;
+	}
+}
+
+LightRenderer::LightRendererJob::LightRendererJob(LightRenderer *renderer, const GradientRenderer *gradients, int width, const Real *data, const Real *down, const Real *up, unsigned char *buffer, PixelFormat format) :
+	renderer(renderer), gradients(gradients), width(width), data(data), down(down), up(up), buffer(buffer), format(format)
+{
+	assert (renderer);
+}
+
+void LightRenderer::LightRendererJob::execute ()
+{
+	// colours the line in RGBA first, lights it and converts it to the image format afterwards
+	std::vector<unsigned char> line(width*4);
+	if (gradients)
+		gradients->renderLine (data, width, &line[0], PF_RGBA8);
+	else
+		memset (&line[0], 255, width*4);
+
+	const Real ix = renderer->mIntensityX;
+	const Real iy = renderer->mIntensityY;
+	const Real io = renderer->mIntensityO;
+	const Real brightness = renderer->mBrightness;
+	const Real ambient = renderer->mAmbient;
+	const Real lightR = renderer->mLightColour.r;
+	const Real lightG = renderer->mLightColour.g;
+	const Real lightB = renderer->mLightColour.b;
+	const bool wrap = renderer->mWrap;
+	unsigned char *out = &line[0];
+	for (int x=0;x<width;++x)
+	{
+		int left = x - 1;
+		int right = x + 1;
+		if (left < 0)
+			left = wrap ? width - 1 : 0;
+		if (right >= width)
+			right = wrap ? 0 : width - 1;
+		Real intensity = ix * (data[left] - data[right]) + iy * (down[x] - up[x]) + io;
+		if (intensity < Real(0))
+			intensity = Real(0);
+		intensity *= brightness;
+		const Real r = out[0] * (ambient + intensity * lightR);
+		const Real g = out[1] * (ambient + intensity * lightG);
+		const Real b = out[2] * (ambient + intensity * lightB);
+		// negative ambient, brightness or light colour can push the values below 0
+		out[0] = (r > Real(0)) ? ((r < Real(255)) ? (unsigned char)r : 255) : 0;
+		out[1] = (g > Real(0)) ? ((g < Real(255)) ? (unsigned char)g : 255) : 0;
+		out[2] = (b > Real(0)) ? ((b < Real(255)) ? (unsigned char)b : 255) : 0;
+		out += 4;
+	}
+	Image::convertFromRGBA (&line[0], width, buffer, format);
+}
+
+void LightRenderer::LightRendererJob::finish ()
+{
+	if (renderer->mCallback)
+		renderer->mCallback->callback ();
+}
+
+};
+};
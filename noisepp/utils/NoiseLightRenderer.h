@@ -0,0 +1,126 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISELIGHTRENDERER_H
+#define NOISELIGHTRENDERER_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseColourValue.h"
+#include "NoiseImage.h"
+#include "NoiseBuilders.h"
+#include "NoiseJobQueue.h"
+#include "NoiseGradientRenderer.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// Renderer for lit terrain (hillshading).
+/// The surface normal of each pixel is calculated from the neighbouring values and lit by a directional light.
+/// The light settings are compatible to the ones of libnoise's RendererImage.
+/// The lit values are multiplied with the colours of a GradientRenderer.
+class LightRenderer
+{
+	public:
+		/// Constructor.
+		LightRenderer();
+		/// Sets the azimuth of the light source in degrees (default is 45).
+		/// The azimuth is the direction of the light source, 0 is east, 90 is north.
+		void setLightAzimuth (Real azimuth);
+		/// Returns the azimuth of the light source in degrees.
+		Real getLightAzimuth () const;
+		/// Sets the elevation of the light source in degrees (default is 45).
+		/// 0 is at the horizon, 90 is straight up.
+		void setLightElevation (Real elevation);
+		/// Returns the elevation of the light source in degrees.
+		Real getLightElevation () const;
+		/// Sets the contrast of the light (default is 1).
+		/// Increase this if the value range of the data is small compared to the distance between the pixels.
+		void setLightContrast (Real contrast);
+		/// Returns the contrast of the light.
+		Real getLightContrast () const;
+		/// Sets the brightness of the light (default is 1).
+		void setLightBrightness (Real brightness);
+		/// Returns the brightness of the light.
+		Real getLightBrightness () const;
+		/// Sets the ambient light intensity (default is 0).
+		void setAmbient (Real ambient);
+		/// Returns the ambient light intensity.
+		Real getAmbient () const;
+		/// Sets the light colour (default is white).
+		void setLightColour (const ColourValue &colour);
+		/// Returns the light colour.
+		const ColourValue &getLightColour () const;
+		/// Enables or disables wrapping at the image borders (for seamless data).
+		void setWrap (bool v=true);
+		/// Returns if wrapping at the image borders is enabled.
+		bool isWrap () const;
+		/// Renders the data to an image.
+		/// @param image The image to render to.
+		/// @param data The source data.
+		/// @param gradients The renderer used to colour the data. Passing NULL will light a white surface.
+		/// @param jobQueue A pointer to a JobQueue. The JobQueue will be deleted after usage. Passing NULL will use an system optimal queue.
+		void renderImage (Image &image, const Real *data, GradientRenderer *gradients=0, JobQueue *jobQueue=0);
+		/// Sets a callback
+		void setCallback (BuilderCallback *callback);
+		/// Destructor.
+		~LightRenderer();
+	protected:
+	private:
+		Real mAzimuth;
+		Real mElevation;
+		Real mContrast;
+		Real mBrightness;
+		Real mAmbient;
+		ColourValue mLightColour;
+		bool mWrap;
+		BuilderCallback *mCallback;
+		// light factors calculated by renderImage()
+		Real mIntensityX, mIntensityY, mIntensityO;
+
+		class LightRendererJob : public Job
+		{
+			private:
+				LightRenderer *renderer;
+				const GradientRenderer *gradients;
+				int width;
+				const Real *data;
+				const Real *down;
+				const Real *up;
+				unsigned char *buffer;
+				PixelFormat format;
+
+			public:
+				LightRendererJob(LightRenderer *renderer, const GradientRenderer *gradients, int width, const Real *data, const Real *down, const Real *up, unsigned char *buffer, PixelFormat format);
+				void execute ();
+				void finish ();
+		};
+};
+
+};
+};
+
+#endif // NOISELIGHTRENDERER_H
@@ -0,0 +1,132 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseMappedFile.h"
+
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#endif
+
+namespace noisepp
+{
+namespace utils
+{
+
+MappedFile::MappedFile () : mData(NULL), mSize(0)
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	, mFile(NULL), mMapping(NULL)
+#endif
+{
+}
+
+MappedFile::MappedFile (const std::string &filename) : mData(NULL), mSize(0)
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	, mFile(NULL), mMapping(NULL)
+#endif
+{
+	open (filename);
+}
+
+bool MappedFile::open (const std::string &filename)
+{
+	close ();
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+	int fd = ::open (filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat (fd, &st) != 0 || st.st_size <= 0)
+	{
+		::close (fd);
+		return false;
+	}
+	void *data = mmap (NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after closing the descriptor
+	::close (fd);
+	if (data == MAP_FAILED)
+		return false;
+	mData = static_cast<const unsigned char*>(data);
+	mSize = (size_t)st.st_size;
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	HANDLE file = CreateFileA (filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	DWORD size = GetFileSize (file, NULL);
+	if (size == INVALID_FILE_SIZE || size == 0)
+	{
+		CloseHandle (file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA (file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping)
+	{
+		CloseHandle (file);
+		return false;
+	}
+	void *data = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle (mapping);
+		CloseHandle (file);
+		return false;
+	}
+	mFile = file;
+	mMapping = mapping;
+	mData = static_cast<const unsigned char*>(data);
+	mSize = size;
+#endif
+	return true;
+}
+
+void MappedFile::close ()
+{
+	if (!mData)
+		return;
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
+	munmap (const_cast<unsigned char*>(mData), mSize);
+#elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+	UnmapViewOfFile (mData);
+	CloseHandle (mMapping);
+	CloseHandle (mFile);
+	mMapping = NULL;
+	mFile = NULL;
+#endif
+	mData = NULL;
+	mSize = 0;
+}
+
+MappedFile::~MappedFile ()
+{
+	close ();
+}
+
+};
+};
@@ -0,0 +1,82 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEMAPPEDFILE_H
+#define NOISEMAPPEDFILE_H
+
+#include "NoisePrerequisites.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// Read-only memory mapped file.
+class MappedFile
+{
+	private:
+		const unsigned char *mData;
+		size_t mSize;
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
+		void *mFile;
+		void *mMapping;
+#endif
+
+		MappedFile (const MappedFile &);
+		MappedFile &operator= (const MappedFile &);
+	public:
+		/// Constructor.
+		MappedFile ();
+		/// Constructor.
+		/// @param filename The name of the file to map.
+		MappedFile (const std::string &filename);
+		/// Maps the specified file into memory.
+		/// Returns true on success, and false otherwise.
+		bool open (const std::string &filename);
+		/// Check if a file is mapped.
+		bool isOpen () const
+		{
+			return mData != NULL;
+		}
+		/// Unmaps the current file.
+		void close ();
+		/// Returns a pointer to the file contents.
+		const unsigned char *getData () const
+		{
+			return mData;
+		}
+		/// Returns the file size.
+		size_t getSize () const
+		{
+			return mSize;
+		}
+		/// Destructor.
+		~MappedFile ();
+};
+
+};
+};
+
+#endif // NOISEMAPPEDFILE_H
@@ -96,12 +96,16 @@ void CurveModule::read (utils::InStream &s)
 {
 	mControlPoints.clear ();
 	int count = s.readInt ();
+	mControlPoints.reserve (count);
 	for (int i=0;i<count;++i)
 	{
-		double inValue = s.readDouble ();
-		double outValue = s.readDouble ();
-		addControlPoint (inValue, outValue);
+		CurveControlPoint point;
+		point.inValue = s.readDouble ();
+		point.outValue = s.readDouble ();
+		mControlPoints.push_back (point);
 	}
+	// sorted once instead of for every point
+	std::sort (mControlPoints.begin(), mControlPoints.end());
 }
 
 void ExponentModule::write (utils::OutStream &s) const
@@ -196,10 +200,13 @@ void TerraceModule::read (utils::InStream &s)
 	mControlPoints.clear ();
 	mInvert = (s.readInt() != 0);
 	int count = s.readInt ();
+	mControlPoints.reserve (count);
 	for (int i=0;i<count;++i)
 	{
-		addControlPoint (s.readDouble());
+		mControlPoints.push_back (s.readDouble());
 	}
+	// sorted once instead of for every point
+	std::sort (mControlPoints.begin(), mControlPoints.end());
 }
 
 void TranslatePointModule::write (utils::OutStream &s) const
@@ -250,4 +257,49 @@ void VoronoiModule::read (utils::InStream &s)
 	mEnableDistance = (s.readInt() != 0);
 }
 
+// the bounds must be ordered and their distance finite, like setBounds() requires (NaN fails both)
+static bool isValidBakedGridAxis (Real lower, Real upper)
+{
+	return lower < upper && upper - lower <= (std::numeric_limits<Real>::max)();
+}
+
+void BakedGridModule::write (utils::OutStream &s) const
+{
+	s.writeDouble (mLowerBoundX);
+	s.writeDouble (mLowerBoundY);
+	s.writeDouble (mLowerBoundZ);
+	s.writeDouble (mUpperBoundX);
+	s.writeDouble (mUpperBoundY);
+	s.writeDouble (mUpperBoundZ);
+	s.writeInt (mResolutionX);
+	s.writeInt (mResolutionY);
+	s.writeInt (mResolutionZ);
+	s.writeInt (mInterpolation);
+	s.writeInt (mOutsideMode);
+}
+
+void BakedGridModule::read (utils::InStream &s)
+{
+	mLowerBoundX = s.readDouble ();
+	mLowerBoundY = s.readDouble ();
+	mLowerBoundZ = s.readDouble ();
+	mUpperBoundX = s.readDouble ();
+	mUpperBoundY = s.readDouble ();
+	mUpperBoundZ = s.readDouble ();
+	mResolutionX = s.readInt ();
+	mResolutionY = s.readInt ();
+	mResolutionZ = s.readInt ();
+	mInterpolation = s.readInt ();
+	mOutsideMode = s.readInt ();
+	if (mResolutionX < 2 || mResolutionY < 2 || mResolutionZ < 2)
+		throw ReaderException ("Invalid baked grid resolution");
+	if (!isValidBakedGridAxis(mLowerBoundX, mUpperBoundX) || !isValidBakedGridAxis(mLowerBoundY, mUpperBoundY) ||
+		!isValidBakedGridAxis(mLowerBoundZ, mUpperBoundZ))
+		throw ReaderException ("Invalid baked grid bounds");
+	if (mInterpolation != BAKEDGRID_INTERPOLATION_LINEAR && mInterpolation != BAKEDGRID_INTERPOLATION_CUBIC)
+		throw ReaderException ("Invalid baked grid interpolation");
+	if (mOutsideMode != BAKEDGRID_OUTSIDE_SOURCE && mOutsideMode != BAKEDGRID_OUTSIDE_WRAP && mOutsideMode != BAKEDGRID_OUTSIDE_CLAMP)
+		throw ReaderException ("Invalid baked grid outside mode");
+}
+
 };
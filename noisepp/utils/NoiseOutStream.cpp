@@ -24,6 +24,7 @@
 //
 
 #include <cassert>
+#include <new>
 #include "NoiseOutStream.h"
 #include "NoiseEndianUtils.h"
 
@@ -42,17 +43,20 @@ OutStream::~OutStream()
 {
 }
 
-FileOutStream::FileOutStream ()
+const size_t FileOutStream::DEFAULT_BUFFER_SIZE;
+
+FileOutStream::FileOutStream () : mBuffer(DEFAULT_BUFFER_SIZE), mBufferPosition(0)
 {
 }
 
-FileOutStream::FileOutStream(const std::string &filename)
+FileOutStream::FileOutStream(const std::string &filename, size_t bufferSize) : mBuffer(bufferSize), mBufferPosition(0)
 {
 	open (filename);
 }
 
 bool FileOutStream::open (const std::string &filename)
 {
+	mBufferPosition = 0;
 	mFile.open (filename.c_str(), std::ios::binary);
 	return mFile.is_open ();
 }
@@ -64,24 +68,62 @@ bool FileOutStream::isOpen ()
 
 void FileOutStream::close ()
 {
+	flush ();
 	mFile.close ();
 }
 
+void FileOutStream::flush ()
+{
+	if (mBufferPosition > 0)
+	{
+		mFile.write (&mBuffer[0], (std::streamsize)mBufferPosition);
+		mBufferPosition = 0;
+	}
+}
+
+void FileOutStream::setBufferSize (size_t size)
+{
+	flush ();
+	std::vector<char> buffer(size);
+	mBuffer.swap (buffer);
+}
+
 void FileOutStream::write (const void *buffer, size_t len)
 {
-	mFile.write ((const char*)buffer, (std::streamsize)len);
+	if (mBufferPosition + len > mBuffer.size())
+	{
+		flush ();
+		// big writes bypass the buffer
+		if (len >= mBuffer.size())
+		{
+			mFile.write ((const char*)buffer, (std::streamsize)len);
+			return;
+		}
+	}
+	if (len)
+	{
+		std::memcpy (&mBuffer[mBufferPosition], buffer, len);
+		mBufferPosition += len;
+	}
 }
 
 size_t FileOutStream::tell ()
 {
-	return mFile.tellp ();
+	return (size_t)mFile.tellp () + mBufferPosition;
 }
 
 void FileOutStream::seek (size_t pos)
 {
+	flush ();
 	mFile.seekp ((std::streamoff)pos);
 }
 
+FileOutStream::~FileOutStream ()
+{
+	if (mFile.is_open())
+		flush ();
+}
+
 MemoryOutStream::MemoryOutStream () : mBuffer(NULL), mPosition(0), mSize(0), mRealSize(0)
 {
 }
@@ -101,13 +143,29 @@ void MemoryOutStream::clear ()
 	mPosition = mSize = mRealSize = 0;
 }
 
+void MemoryOutStream::reserve (size_t size)
+{
+	if (size > mRealSize)
+	{
+		char *buffer = (char *)std::realloc (mBuffer, size);
+		if (!buffer)
+			throw std::bad_alloc ();
+		mBuffer = buffer;
+		mRealSize = size;
+	}
+}
+
 void MemoryOutStream::write (const void *buffer, size_t len)
 {
-	assert (len > 0);
-	if (mPosition+len > mRealSize || mBuffer == NULL)
+	if (len == 0)
+		return;
+	if (mPosition+len > mRealSize)
 	{
-		mRealSize += BLOCK_SIZE;
-		mBuffer = (char *)std::realloc (mBuffer, mRealSize);
+		// doubles the buffer to keep repeated writes linear
+		size_t size = mRealSize ? mRealSize*2 : BLOCK_SIZE;
+		if (size < mPosition+len)
+			size = mPosition+len;
+		reserve (size);
 	}
 	std::memcpy (mBuffer+mPosition, buffer, len);
 	mPosition += len;
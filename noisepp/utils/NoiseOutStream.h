@@ -30,6 +30,7 @@
 #include <cstring>
 #include <string>
 #include <fstream>
+#include <vector>
 
 #include "NoiseEndianUtils.h"
 
@@ -60,6 +61,29 @@ class OutStream
 			EndianUtils::flipEndian (&t, sizeof(T));
 			write (&t, sizeof(T));
 		}
+		/// Write an array to stream and flip endian if required.
+		/// @param array The source array.
+		/// @param count The number of elements.
+		template <class T>
+		void writeArray (const T *array, size_t count)
+		{
+#if NOISEPP_BIG_ENDIAN
+			// flipped in blocks on the stack
+			const size_t BLOCK_COUNT = 1024 / sizeof(T) + 1;
+			T block[BLOCK_COUNT];
+			while (count > 0)
+			{
+				const size_t n = (count < BLOCK_COUNT) ? count : BLOCK_COUNT;
+				std::memcpy (block, array, n*sizeof(T));
+				EndianUtils::flipEndianArray (block, sizeof(T), n);
+				write (block, n*sizeof(T));
+				array += n;
+				count -= n;
+			}
+#else
+			write (array, count*sizeof(T));
+#endif
+		}
 		/// Write an integer.
 		void writeInt (int t)
 		{
@@ -74,17 +98,23 @@ class OutStream
 	private:
 };
 
-/// Stream for writing to files.
+/// Buffered stream for writing to files.
 class FileOutStream : public OutStream
 {
 	private:
 		std::ofstream mFile;
+		std::vector<char> mBuffer;
+		size_t mBufferPosition;
 	public:
+		/// Default size of the write buffer.
+		static const size_t DEFAULT_BUFFER_SIZE = 65536;
+
 		/// Constructor.
 		FileOutStream();
 		/// Constructor.
 		/// @param filename The name of the output file.
-		FileOutStream(const std::string &filename);
+		/// @param bufferSize The size of the write buffer.
+		FileOutStream(const std::string &filename, size_t bufferSize=DEFAULT_BUFFER_SIZE);
 		/// Open the specified file for writing.
 		/// Returns true on success.
 		bool open (const std::string &filename);
@@ -93,12 +123,28 @@ class FileOutStream : public OutStream
 		bool isOpen ();
 		/// Close the current file.
 		void close ();
+		/// Writes the buffered data to the file.
+		void flush ();
+		/// Sets the size of the write buffer. Writes bigger than the buffer bypass it.
+		void setBufferSize (size_t size);
+		/// Returns the size of the write buffer.
+		size_t getBufferSize () const
+		{
+			return mBuffer.size();
+		}
 		/// @copydoc noisepp::utils::OutStream::write(T)
 		template <class T>
 		void write (T t)
 		{
 			EndianUtils::flipEndian (&t, sizeof(T));
-			write (&t, sizeof(T));
+			// small values are copied to the buffer directly
+			if (mBufferPosition + sizeof(T) <= mBuffer.size())
+			{
+				std::memcpy (&mBuffer[mBufferPosition], &t, sizeof(T));
+				mBufferPosition += sizeof(T);
+			}
+			else
+				write (&t, sizeof(T));
 		}
 		/// @copydoc noisepp::utils::OutStream::write(const void *, size_t)
 		virtual void write (const void *buffer, size_t len);
@@ -106,9 +152,12 @@ class FileOutStream : public OutStream
 		virtual size_t tell ();
 		/// @copydoc noisepp::utils::OutStream::seek()
 		virtual void seek (size_t pos);
+		/// Destructor.
+		virtual ~FileOutStream ();
 };
 
 /// Stream for writing to memory.
+/// The buffer grows geometrically.
 class MemoryOutStream : public OutStream
 {
 	private:
@@ -119,6 +168,8 @@ class MemoryOutStream : public OutStream
 		MemoryOutStream ();
 		/// Clears the buffer.
 		void clear ();
+		/// Makes sure the buffer can hold the specified number of bytes without growing.
+		void reserve (size_t size);
 		/// Returns a pointer to the buffer.
 		char *getBuffer ()
 		{
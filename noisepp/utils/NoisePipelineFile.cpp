@@ -0,0 +1,217 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoisePipelineFile.h"
+#include "NoiseUtils.h"
+
+// size of the fixed file header (tag, seed, module count), followed by the element ID table
+#define NOISE_PIPELINEFILE_HEADER_SIZE 12
+
+namespace noisepp
+{
+namespace utils
+{
+
+// reads a little endian int
+static int readPipelineFileInt (const unsigned char *bytes)
+{
+	return (int)((unsigned)bytes[0] | ((unsigned)bytes[1] << 8) | ((unsigned)bytes[2] << 16) | ((unsigned)bytes[3] << 24));
+}
+
+PipelineFile::PipelineFile () : mReader(NULL), mSeed(0)
+{
+}
+
+template <class Element>
+void PipelineFile::savePipeline (OutStream &stream, const Pipeline<Element> &pipe)
+{
+	NoiseAssert (pipe.getElementCount() > 0, pipe);
+	// the sources and internal modules of all element modules are no roots
+	const ElementID elementCount = pipe.getElementCount ();
+	std::set<const Module*> used;
+	for (ElementID i=0;i<elementCount;++i)
+	{
+		const Module *module = pipe.getElementModule(i);
+		for (size_t n=0;n<module->getSourceModuleCount();++n)
+			used.insert (module->getSourceModule(n));
+		for (size_t n=0;n<module->getInternalModuleCount();++n)
+			used.insert (module->getInternalModule(n));
+	}
+	// the writer adds the sources of the roots
+	Writer writer(stream);
+	for (ElementID i=0;i<elementCount;++i)
+	{
+		const Module *module = pipe.getElementModule(i);
+		if (used.find(module) == used.end())
+			writer.addModule (module);
+	}
+	stream.write ("NPPF", 4);
+	int seed = pipe.getSeed ();
+	stream.write (seed);
+	int count = writer.getModuleCount ();
+	stream.write (count);
+	for (int i=0;i<count;++i)
+	{
+		ElementID id = pipe.getElementID (writer.getModule((unsigned short)i));
+		NoiseAssert (id != ELEMENTID_INVALID, id);
+		int value = (int)id;
+		stream.write (value);
+	}
+	// keeps the mapped pipeline 8 byte aligned
+	if ((count & 1) == 0)
+	{
+		int padding = 0;
+		stream.write (padding);
+	}
+	writer.writeMappedPipeline ();
+}
+
+void PipelineFile::save (OutStream &stream, const Pipeline1D &pipe)
+{
+	savePipeline (stream, pipe);
+}
+
+void PipelineFile::save (OutStream &stream, const Pipeline2D &pipe)
+{
+	savePipeline (stream, pipe);
+}
+
+void PipelineFile::save (OutStream &stream, const Pipeline3D &pipe)
+{
+	savePipeline (stream, pipe);
+}
+
+bool PipelineFile::open (const std::string &filename)
+{
+	close ();
+	if (!mFile.open (filename))
+		return false;
+	open (mFile.getData(), mFile.getSize());
+	return true;
+}
+
+void PipelineFile::open (const void *data, size_t size)
+{
+	NoiseAssert (data != NULL, data);
+	if (mReader)
+	{
+		delete mReader;
+		mReader = NULL;
+	}
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+	if (size < NOISE_PIPELINEFILE_HEADER_SIZE || memcmp(bytes, "NPPF", 4) != 0)
+		throw ReaderException ("Invalid pipeline file header");
+	const int count = readPipelineFileInt (bytes+8);
+	// header and element ID table, padded to 8 bytes
+	const size_t offset = (NOISE_PIPELINEFILE_HEADER_SIZE + (size_t)count*4 + 7) & ~(size_t)7;
+	if (count <= 0 || count > 0xFFFF || size <= offset || bytes[offset] != NOISE_FILE_VERSION_MAPPED)
+		throw ReaderException ("Invalid pipeline file header");
+	mSeed = readPipelineFileInt (bytes+4);
+	mElementIDs.resize (count);
+	for (int i=0;i<count;++i)
+		mElementIDs[i] = (ElementID)readPipelineFileInt (bytes+NOISE_PIPELINEFILE_HEADER_SIZE+i*4);
+	mReader = new Reader(bytes+offset, size-offset);
+	if (mReader->getModuleCount() != count)
+		throw ReaderException ("Invalid pipeline file header");
+}
+
+void PipelineFile::close ()
+{
+	if (mReader)
+	{
+		delete mReader;
+		mReader = NULL;
+	}
+	mFile.close ();
+	mSeed = 0;
+	mElementIDs.clear ();
+	mRestoredIDs.clear ();
+}
+
+unsigned short PipelineFile::getModuleCount () const
+{
+	NoiseAssert (mReader != NULL, mReader);
+	return mReader->getModuleCount ();
+}
+
+Module *PipelineFile::getModule (unsigned short index)
+{
+	NoiseAssert (mReader != NULL, mReader);
+	NoiseAssertRange (index, getModuleCount());
+	return mReader->getModule (index);
+}
+
+ElementID PipelineFile::getElementID (unsigned short index) const
+{
+	NoiseAssertRange (index, mElementIDs.size());
+	return mElementIDs[index];
+}
+
+ElementID PipelineFile::getRestoredElementID (ElementID savedID) const
+{
+	std::map<ElementID, ElementID>::const_iterator it = mRestoredIDs.find(savedID);
+	if (it != mRestoredIDs.end())
+		return it->second;
+	return ELEMENTID_INVALID;
+}
+
+template <class Element>
+void PipelineFile::restorePipeline (Pipeline<Element> &pipe)
+{
+	NoiseAssert (mReader != NULL, mReader);
+	NoiseAssert (pipe.getElementCount() == 0, pipe);
+	pipe.setSeed (mSeed);
+	// adding the modules in the order of their saved element IDs repeats the order they were built in
+	std::map<ElementID, unsigned short> order;
+	const unsigned short count = getModuleCount ();
+	for (unsigned short i=0;i<count;++i)
+		order.insert (std::make_pair(mElementIDs[i], i));
+	mRestoredIDs.clear ();
+	for (std::map<ElementID, unsigned short>::iterator it=order.begin();it!=order.end();++it)
+		mRestoredIDs[it->first] = getModule(it->second)->addToPipeline (&pipe);
+}
+
+void PipelineFile::restore (Pipeline1D &pipe)
+{
+	restorePipeline (pipe);
+}
+
+void PipelineFile::restore (Pipeline2D &pipe)
+{
+	restorePipeline (pipe);
+}
+
+void PipelineFile::restore (Pipeline3D &pipe)
+{
+	restorePipeline (pipe);
+}
+
+PipelineFile::~PipelineFile ()
+{
+	close ();
+}
+
+};
+};
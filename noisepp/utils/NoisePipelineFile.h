@@ -0,0 +1,104 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPIPELINEFILE_H
+#define NOISEPIPELINEFILE_H
+
+#include <vector>
+#include <map>
+
+#include "NoisePrerequisites.h"
+#include "NoiseModule.h"
+#include "NoiseOutStream.h"
+#include "NoiseMappedFile.h"
+#include "NoiseReader.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// File holding the module graph of a built pipeline.
+/// The file stores the modules of a pipeline in the mapped module format (see Writer::writeMappedPipeline()) together with
+/// the element ID of every module and the master seed.
+/// Only modules reachable through Module::getSourceModule() are stored, elements a module adds internally (e.g. the Perlin
+/// elements of Turbulence) are created again by their owner.
+/// Restoring saves parsing the modules, the elements are built again by Module::addToPipeline().
+/// They are added in the order of their saved element IDs, use getRestoredElementID() to map a saved element ID to the restored one.
+class PipelineFile
+{
+	private:
+		MappedFile mFile;
+		Reader *mReader;
+		int mSeed;
+		std::vector<ElementID> mElementIDs;
+		std::map<ElementID, ElementID> mRestoredIDs;
+
+		template <class Element>
+		static void savePipeline (OutStream &stream, const Pipeline<Element> &pipe);
+		template <class Element>
+		void restorePipeline (Pipeline<Element> &pipe);
+
+		PipelineFile (const PipelineFile &);
+		PipelineFile &operator= (const PipelineFile &);
+	public:
+		/// Constructor.
+		PipelineFile ();
+		/// Writes the modules of the pipeline to the stream.
+		static void save (OutStream &stream, const Pipeline1D &pipe);
+		/// Writes the modules of the pipeline to the stream.
+		static void save (OutStream &stream, const Pipeline2D &pipe);
+		/// Writes the modules of the pipeline to the stream.
+		static void save (OutStream &stream, const Pipeline3D &pipe);
+		/// Maps the specified file.
+		/// Returns true on success, and false otherwise.
+		bool open (const std::string &filename);
+		/// Opens a file from memory. The data must be valid as long as the object exists.
+		void open (const void *data, size_t size);
+		/// Closes the file.
+		void close ();
+		/// Returns the number of modules in the file.
+		unsigned short getModuleCount () const;
+		/// Returns the module with the specified index.
+		Module *getModule (unsigned short index);
+		/// Returns the element ID the specified module had in the saved pipeline.
+		ElementID getElementID (unsigned short index) const;
+		/// Returns the element ID a saved element got in the last restored pipeline or ELEMENTID_INVALID if it was not restored.
+		ElementID getRestoredElementID (ElementID savedID) const;
+		/// Adds all modules to an empty pipeline.
+		/// The file must stay open as long as the pipeline exists, the pipeline refers to its modules.
+		void restore (Pipeline1D &pipe);
+		/// @copydoc restore(Pipeline1D &)
+		void restore (Pipeline2D &pipe);
+		/// @copydoc restore(Pipeline1D &)
+		void restore (Pipeline3D &pipe);
+		/// Destructor.
+		~PipelineFile ();
+};
+
+};
+};
+
+#endif // NOISEPIPELINEFILE_H
@@ -0,0 +1,146 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseProfileReport.h"
+
+#if NOISEPP_ENABLE_PROFILING
+
+#include <cstdio>
+
+namespace noisepp
+{
+namespace utils
+{
+
+static bool compareEntries (const ProfileReport::Entry &a, const ProfileReport::Entry &b)
+{
+	const double ta = a.counters.getEstimatedExclusiveTime ();
+	const double tb = b.counters.getEstimatedExclusiveTime ();
+	if (ta != tb)
+		return ta > tb;
+	return a.element < b.element;
+}
+
+template <class Element>
+void ProfileReport::collect (const Pipeline<Element> &pipe)
+{
+	std::vector<ProfileCounters> profile;
+	pipe.getProfile (profile);
+	mEntries.resize (profile.size());
+	for (size_t i=0;i<profile.size();++i)
+	{
+		mEntries[i].element = i;
+		mEntries[i].type = pipe.getElementType (i);
+		mEntries[i].counters = profile[i];
+	}
+	std::sort (mEntries.begin(), mEntries.end(), compareEntries);
+}
+
+ProfileReport::ProfileReport (const Pipeline1D &pipe)
+{
+	collect (pipe);
+}
+
+ProfileReport::ProfileReport (const Pipeline2D &pipe)
+{
+	collect (pipe);
+}
+
+ProfileReport::ProfileReport (const Pipeline3D &pipe)
+{
+	collect (pipe);
+}
+
+std::string ProfileReport::toString () const
+{
+	char buffer[256];
+	std::string str;
+	sprintf (buffer, "%8s %-16s %12s %12s %10s %12s %12s\n", "element", "module", "evaluations", "cache hits", "samples", "incl. ms", "excl. ms");
+	str += buffer;
+	for (size_t i=0;i<mEntries.size();++i)
+	{
+		const Entry &e = mEntries[i];
+		sprintf (buffer, "%8lu %-16s %12lu %12lu %10lu %12.3f %12.3f\n", (unsigned long)e.element, getModuleTypeName(e.type),
+			e.counters.misses, e.counters.hits, e.counters.samples,
+			e.counters.getEstimatedInclusiveTime() * 1000.0, e.counters.getEstimatedExclusiveTime() * 1000.0);
+		str += buffer;
+	}
+	return str;
+}
+
+std::string ProfileReport::toJSON () const
+{
+	char buffer[512];
+	std::string str = "{\"elements\":[";
+	for (size_t i=0;i<mEntries.size();++i)
+	{
+		const Entry &e = mEntries[i];
+		sprintf (buffer, "%s\n{\"id\":%lu,\"type\":\"%s\",\"typeId\":%u,\"evaluations\":%lu,\"cacheHits\":%lu,\"samples\":%lu,"
+			"\"sampledInclusiveTime\":%.9g,\"sampledExclusiveTime\":%.9g,\"inclusiveTime\":%.9g,\"exclusiveTime\":%.9g}",
+			i ? "," : "", (unsigned long)e.element, getModuleTypeName(e.type), (unsigned)e.type,
+			e.counters.misses, e.counters.hits, e.counters.samples, e.counters.inclusiveTime, e.counters.exclusiveTime,
+			e.counters.getEstimatedInclusiveTime(), e.counters.getEstimatedExclusiveTime());
+		str += buffer;
+	}
+	str += "\n]}\n";
+	return str;
+}
+
+const char *ProfileReport::getModuleTypeName (ModuleTypeId type)
+{
+	switch (type)
+	{
+		case MODULE_PERLIN: return "Perlin";
+		case MODULE_BILLOW: return "Billow";
+		case MODULE_ADDITION: return "Addition";
+		case MODULE_ABSOLUTE: return "Absolute";
+		case MODULE_BLEND: return "Blend";
+		case MODULE_CHECKERBOARD: return "Checkerboard";
+		case MODULE_CLAMP: return "Clamp";
+		case MODULE_CONSTANT: return "Constant";
+		case MODULE_CURVE: return "Curve";
+		case MODULE_EXPONENT: return "Exponent";
+		case MODULE_INVERT: return "Invert";
+		case MODULE_MAXIMUM: return "Maximum";
+		case MODULE_MINIMUM: return "Minimum";
+		case MODULE_MULTIPLY: return "Multiply";
+		case MODULE_POWER: return "Power";
+		case MODULE_RIDGEDMULTI: return "RidgedMulti";
+		case MODULE_SCALEBIAS: return "ScaleBias";
+		case MODULE_SELECT: return "Select";
+		case MODULE_SCALEPOINT: return "ScalePoint";
+		case MODULE_TURBULENCE: return "Turbulence";
+		case MODULE_TERRACE: return "Terrace";
+		case MODULE_TRANSLATEPOINT: return "TranslatePoint";
+		case MODULE_VORONOI: return "Voronoi";
+		case MODULE_BAKEDGRID: return "BakedGrid";
+	}
+	return "Unknown";
+}
+
+};
+};
+
+#endif // NOISEPP_ENABLE_PROFILING
@@ -0,0 +1,94 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEPROFILEREPORT_H
+#define NOISEPROFILEREPORT_H
+
+#include "NoisePrerequisites.h"
+#include "NoisePipeline.h"
+#include "NoiseModule.h"
+
+#if NOISEPP_ENABLE_PROFILING
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// Report of the profiling counters of a pipeline (see NOISEPP_ENABLE_PROFILING in NoiseConfig.h).
+/// The entries are sorted by the estimated exclusive time, the most expensive element first.
+class ProfileReport
+{
+	public:
+		/// Report entry of one pipeline element.
+		struct Entry
+		{
+			/// The element ID.
+			ElementID element;
+			/// The type of the module the element was created from.
+			ModuleTypeId type;
+			/// The counters summed up over all threads.
+			ProfileCounters counters;
+		};
+
+	private:
+		std::vector<Entry> mEntries;
+
+		template <class Element>
+		void collect (const Pipeline<Element> &pipe);
+	public:
+		/// Constructor, creates the report from the current counters of the pipeline.
+		ProfileReport (const Pipeline1D &pipe);
+		/// Constructor, creates the report from the current counters of the pipeline.
+		ProfileReport (const Pipeline2D &pipe);
+		/// Constructor, creates the report from the current counters of the pipeline.
+		ProfileReport (const Pipeline3D &pipe);
+
+		/// Returns the number of entries.
+		size_t getEntryCount () const
+		{
+			return mEntries.size ();
+		}
+		/// Returns an entry.
+		const Entry &getEntry (size_t i) const
+		{
+			NoiseAssertRange (i, mEntries.size());
+			return mEntries[i];
+		}
+		/// Returns the report as text table.
+		std::string toString () const;
+		/// Returns the report as JSON.
+		std::string toJSON () const;
+
+		/// Returns the name of a module type.
+		static const char *getModuleTypeName (ModuleTypeId type);
+};
+
+};
+};
+
+#endif // NOISEPP_ENABLE_PROFILING
+
+#endif // NOISEPROFILEREPORT_H
@@ -34,27 +34,144 @@ namespace noisepp
 namespace utils
 {
 
-Reader::Reader (InStream &stream) : mStream(stream), mModuleCount(0)
+// reads a little endian value from a mapped file
+static inline unsigned readUInt32 (const unsigned char *p)
+{
+	return (unsigned)p[0] | ((unsigned)p[1] << 8) | ((unsigned)p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+static inline unsigned short readUInt16 (const unsigned char *p)
+{
+	return (unsigned short)(p[0] | (p[1] << 8));
+}
+
+Reader::Reader (InStream &stream) : mModuleCount(0), mData(NULL), mSize(0)
 {
 	unsigned char ver;
 	stream.read (ver);
+	if (ver == NOISE_FILE_VERSION_MAPPED)
+	{
+		// copies the file to memory and uses it like a mapped one
+		unsigned char header[NOISE_MAPPED_HEADER_SIZE];
+		header[0] = ver;
+		stream.read (header+1, NOISE_MAPPED_HEADER_SIZE-1);
+		const unsigned fileSize = readUInt32 (header+20);
+		if (fileSize < NOISE_MAPPED_HEADER_SIZE)
+			throw ReaderException ("Invalid file size");
+		mBuffer.resize (fileSize);
+		memcpy (&mBuffer[0], header, NOISE_MAPPED_HEADER_SIZE);
+		if (fileSize > NOISE_MAPPED_HEADER_SIZE)
+			stream.read (&mBuffer[NOISE_MAPPED_HEADER_SIZE], fileSize-NOISE_MAPPED_HEADER_SIZE);
+		mData = &mBuffer[0];
+		mSize = mBuffer.size();
+		openMapped ();
+		return;
+	}
 	if (ver != NOISE_FILE_VERSION)
 		throw ReaderException ("Input file has wrong version");
+	readPipeline (stream);
+}
+
+Reader::Reader (const void *data, size_t size) : mModuleCount(0), mData(static_cast<const unsigned char*>(data)), mSize(size)
+{
+	NoiseAssert (data != NULL, data);
+	if (mSize < 1)
+		throw ReaderException ("Unexpected EOF");
+	if (mData[0] == NOISE_FILE_VERSION_MAPPED)
+	{
+		openMapped ();
+		return;
+	}
+	if (mData[0] != NOISE_FILE_VERSION)
+		throw ReaderException ("Input file has wrong version");
+	// old files are parsed completely
+	MemoryInStream stream;
+	stream.open (const_cast<char*>(reinterpret_cast<const char*>(mData)), mSize);
+	stream.seek (1);
+	mData = NULL;
+	mSize = 0;
+	readPipeline (stream);
+}
+
+void Reader::readPipeline (InStream &stream)
+{
 	stream.read (mModuleCount);
 	for (unsigned short i=0;i<mModuleCount;++i)
 	{
-		readModule ();
+		readModule (stream);
 	}
 	for (ModuleVector::iterator it=mModules.begin();it!=mModules.end();++it)
 	{
-		readModuleRel (*it);
+		readModuleRel (stream, *it);
 	}
 }
 
-void Reader::readModule ()
+void Reader::openMapped ()
+{
+	if (mSize < NOISE_MAPPED_HEADER_SIZE || memcmp(mData+1, "NPP", 3) != 0)
+		throw ReaderException ("Invalid file header");
+	const unsigned count = readUInt32 (mData+4);
+	const unsigned tableOffset = readUInt32 (mData+8);
+	const unsigned linkOffset = readUInt32 (mData+12);
+	const unsigned dataOffset = readUInt32 (mData+16);
+	const unsigned fileSize = readUInt32 (mData+20);
+	// written without sums of untrusted values, so the checks can't wrap around
+	if (count > 0xffff || fileSize > mSize || tableOffset < NOISE_MAPPED_HEADER_SIZE || tableOffset > fileSize ||
+		count * NOISE_MAPPED_ENTRY_SIZE > fileSize - tableOffset || dataOffset > fileSize || linkOffset > dataOffset ||
+		linkOffset < tableOffset || linkOffset - tableOffset < count * NOISE_MAPPED_ENTRY_SIZE)
+		throw ReaderException ("Invalid file header");
+	mModuleCount = (unsigned short)count;
+	mModules.resize (count, NULL);
+}
+
+Module *Reader::loadMappedModule (unsigned id)
+{
+	if (mModules[id])
+		return mModules[id];
+	const unsigned char *entry = mData + readUInt32 (mData+8) + id * NOISE_MAPPED_ENTRY_SIZE;
+	const unsigned short typeID = readUInt16 (entry);
+	const unsigned short sourceCount = readUInt16 (entry+2);
+	const unsigned firstLink = readUInt32 (entry+4);
+	const unsigned paramOffset = readUInt32 (entry+8);
+	const unsigned paramSize = readUInt32 (entry+12);
+	const unsigned linkOffset = readUInt32 (mData+12);
+	const unsigned dataOffset = readUInt32 (mData+16);
+	const unsigned fileSize = readUInt32 (mData+20);
+	// the header offsets were validated by openMapped(), the entry values are checked without overflow
+	if (paramOffset < dataOffset || paramOffset > fileSize || paramSize > fileSize - paramOffset ||
+		sourceCount > (dataOffset - linkOffset) / 4 || firstLink > (dataOffset - linkOffset) / 4 - sourceCount)
+		throw ReaderException ("Invalid module table entry");
+
+	Module *module = createModule (typeID);
+	// the parameter block is read in place
+	MemoryInStream stream;
+	stream.open (const_cast<char*>(reinterpret_cast<const char*>(mData+paramOffset)), paramSize);
+	try
+	{
+		module->read (stream);
+	}
+	catch (...)
+	{
+		delete module;
+		throw;
+	}
+	// registered before the sources are loaded, so cyclic references end up at the existing module
+	mModules[id] = module;
+	if (sourceCount != module->getSourceModuleCount())
+		throw ReaderException ("Wrong child attribute");
+	const unsigned char *links = mData + linkOffset + firstLink * 4;
+	for (unsigned short i=0;i<sourceCount;++i)
+	{
+		const unsigned childID = readUInt32 (links + i*4);
+		if (childID >= mModuleCount)
+			throw ReaderException ("Wrong child attribute");
+		module->setSourceModule (i, loadMappedModule (childID));
+	}
+	return module;
+}
+
+Module *Reader::createModule (unsigned short typeID)
 {
-	unsigned short typeID;
-	mStream.read (typeID);
 	Module *module = NULL;
 	switch (typeID)
 	{
@@ -127,21 +244,32 @@ void Reader::readModule ()
 		case MODULE_VORONOI:
 			module = new VoronoiModule;
 			break;
+		case MODULE_BAKEDGRID:
+			module = new BakedGridModule;
+			break;
 	}
 	if (!module)
 		throw ReaderException ("Invalid module type ID");
 	assert (module->getType() == typeID);
-	module->read (mStream);
+	return module;
+}
+
+void Reader::readModule (InStream &stream)
+{
+	unsigned short typeID;
+	stream.read (typeID);
+	Module *module = createModule (typeID);
+	module->read (stream);
 	mModules.push_back (module);
 }
 
-void Reader::readModuleRel (Module *module)
+void Reader::readModuleRel (InStream &stream, Module *module)
 {
 	assert (module);
 	for (size_t i=0;i<module->getSourceModuleCount();++i)
 	{
 		unsigned short id;
-		mStream.read (id);
+		stream.read (id);
 		Module *child = getModule(id);
 		if (!child)
 			throw ReaderException ("Wrong child attribute");
@@ -152,7 +280,11 @@ void Reader::readModuleRel (Module *module)
 Module *Reader::getModule (unsigned short id)
 {
 	if (id < mModules.size())
+	{
+		if (mData)
+			return loadMappedModule (id);
 		return mModules[id];
+	}
 	return NULL;
 }
 
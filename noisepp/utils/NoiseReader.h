@@ -40,23 +40,40 @@ namespace utils
 class Reader
 {
 	private:
-		InStream &mStream;
-
 		unsigned short mModuleCount;
 
 		typedef std::vector<Module*> ModuleVector;
 		ModuleVector mModules;
 
-		void readModule ();
-		void readModuleRel (Module *module);
+		// mapped files: modules are created on first access
+		const unsigned char *mData;
+		size_t mSize;
+		std::vector<unsigned char> mBuffer;
+
+		void readPipeline (InStream &stream);
+		void readModule (InStream &stream);
+		void readModuleRel (InStream &stream, Module *module);
+		void openMapped ();
+		Module *loadMappedModule (unsigned id);
+		static Module *createModule (unsigned short typeID);
 	public:
 		/// Constructor.
 		/// @param stream A reference to the stream to read from.
 		Reader (InStream &stream);
+		/// Constructor for reading from memory, e.g. a MappedFile.
+		/// Files written with NOISE_FILE_VERSION_MAPPED are used in place, the modules are only created when requested by getModule().
+		/// @param data The file contents. The data must be valid as long as the reader exists.
+		/// @param size The size of the data.
+		Reader (const void *data, size_t size);
 		/// Destructor.
 		~Reader ();
 		/// Returns a pointer to the module with the specified ID or NULL if it does not exist.
 		Module *getModule (unsigned short id=0);
+		/// Returns the number of modules in the file.
+		unsigned short getModuleCount () const
+		{
+			return mModuleCount;
+		}
 };
 
 };
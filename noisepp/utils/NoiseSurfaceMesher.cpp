@@ -0,0 +1,406 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseSurfaceMesher.h"
+#include "NoiseSystem.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+class SurfaceMesher3D::ColumnJob : public PipelineJob
+{
+	private:
+		Pipeline3D *mPipe;
+		PipelineElement3D *mElement;
+		SurfaceMesher3D *mesher;
+		int cx, cy;
+		Real xDelta, yDelta, zDelta;
+		// samples of the current chunk including one additional sample row at the upper borders
+		std::vector<Real> samples;
+		std::vector<int> solidCounts;
+		std::vector<int> cellVertices;
+
+		Real getValue (Real x, Real y, Real z, Cache *cache)
+		{
+			mPipe->cleanCache (cache);
+			return mElement->getValue(x, y, z, cache);
+		}
+		void sampleSlice (int cz, int k, Cache *cache)
+		{
+			const int n = mesher->mChunkSize + 2;
+			const Real isoLevel = mesher->mIsoLevel;
+			const int gz = cz * mesher->mChunkSize + k;
+			const Real z = mesher->mLowerBoundZ + zDelta*gz;
+			Real *buffer = &samples[k*n*n];
+			int solid = 0;
+			for (int j=0;j<n;++j)
+			{
+				const Real y = mesher->mLowerBoundY + yDelta*(cy*mesher->mChunkSize + j);
+				for (int i=0;i<n;++i)
+				{
+					const Real value = getValue(mesher->mLowerBoundX + xDelta*(cx*mesher->mChunkSize + i), y, z, cache);
+					if (value > isoLevel)
+						++solid;
+					*buffer++ = value;
+				}
+			}
+			solidCounts[k] = solid;
+		}
+		void addQuad (Mesh &mesh, int v0, int v1, int v2, int v3, bool flip)
+		{
+			if (flip)
+				std::swap (v1, v3);
+			mesh.indices.push_back (v0);
+			mesh.indices.push_back (v1);
+			mesh.indices.push_back (v2);
+			mesh.indices.push_back (v0);
+			mesh.indices.push_back (v2);
+			mesh.indices.push_back (v3);
+		}
+		void buildMesh (Mesh &mesh, int cz, Cache *cache)
+		{
+			static const int edges[12][2] =
+			{
+				{0,1}, {2,3}, {4,5}, {6,7},
+				{0,2}, {1,3}, {4,6}, {5,7},
+				{0,4}, {1,5}, {2,6}, {3,7}
+			};
+			const int size = mesher->mChunkSize;
+			const int n = size + 2;
+			const int c = size + 1;
+			const Real isoLevel = mesher->mIsoLevel;
+			const Real baseX = mesher->mLowerBoundX + xDelta*(cx*size);
+			const Real baseY = mesher->mLowerBoundY + yDelta*(cy*size);
+			const Real baseZ = mesher->mLowerBoundZ + zDelta*(cz*size);
+			const int offsets[8] = { 0, 1, n, n+1, n*n, n*n+1, n*n+n, n*n+n+1 };
+
+			// places one vertex in each cell intersecting the surface
+			for (int k=0;k<c;++k)
+			{
+				for (int j=0;j<c;++j)
+				{
+					for (int i=0;i<c;++i)
+					{
+						const Real *v = &samples[(k*n + j)*n + i];
+						int mask = 0;
+						for (int corner=0;corner<8;++corner)
+						{
+							if (v[offsets[corner]] > isoLevel)
+								mask |= (1 << corner);
+						}
+						int &cellVertex = cellVertices[(k*c + j)*c + i];
+						if (mask == 0 || mask == 0xff)
+						{
+							cellVertex = -1;
+							continue;
+						}
+						// averages the crossing points of all edges
+						Real px = 0, py = 0, pz = 0;
+						int crossings = 0;
+						for (int e=0;e<12;++e)
+						{
+							const int a = edges[e][0];
+							const int b = edges[e][1];
+							if (((mask >> a) & 1) == ((mask >> b) & 1))
+								continue;
+							const Real va = v[offsets[a]];
+							const Real vb = v[offsets[b]];
+							const Real t = (isoLevel - va) / (vb - va);
+							px += Real(a & 1) + t * Real((b & 1) - (a & 1));
+							py += Real((a >> 1) & 1) + t * Real(((b >> 1) & 1) - ((a >> 1) & 1));
+							pz += Real((a >> 2) & 1) + t * Real(((b >> 2) & 1) - ((a >> 2) & 1));
+							++crossings;
+						}
+						const Real invCrossings = Real(1) / Real(crossings);
+						const Real x = baseX + xDelta * (Real(i) + px * invCrossings);
+						const Real y = baseY + yDelta * (Real(j) + py * invCrossings);
+						const Real z = baseZ + zDelta * (Real(k) + pz * invCrossings);
+						cellVertex = (int)mesh.getVertexCount ();
+						mesh.positions.push_back ((float)x);
+						mesh.positions.push_back ((float)y);
+						mesh.positions.push_back ((float)z);
+						if (mesher->mNormalMode == NORMALS_GRADIENT)
+						{
+							const Real hx = xDelta * Real(0.5);
+							const Real hy = yDelta * Real(0.5);
+							const Real hz = zDelta * Real(0.5);
+							// the normal points from the solid to the empty side
+							Real nx = (getValue(x-hx, y, z, cache) - getValue(x+hx, y, z, cache)) / hx;
+							Real ny = (getValue(x, y-hy, z, cache) - getValue(x, y+hy, z, cache)) / hy;
+							Real nz = (getValue(x, y, z-hz, cache) - getValue(x, y, z+hz, cache)) / hz;
+							const Real len = sqrt(nx*nx + ny*ny + nz*nz);
+							if (len > Real(0))
+							{
+								nx /= len;
+								ny /= len;
+								nz /= len;
+							}
+							mesh.normals.push_back ((float)nx);
+							mesh.normals.push_back ((float)ny);
+							mesh.normals.push_back ((float)nz);
+						}
+					}
+				}
+			}
+
+			// connects the vertices of the four cells around each edge intersecting the surface
+			// each chunk only handles the edges between its own samples, so there are no duplicate faces at the chunk borders
+			for (int k=0;k<=size;++k)
+			{
+				for (int j=0;j<=size;++j)
+				{
+					for (int i=0;i<=size;++i)
+					{
+						const Real *v = &samples[(k*n + j)*n + i];
+						const bool solid = (*v > isoLevel);
+						const int cell = (k*c + j)*c + i;
+						// edge along the x-axis
+						if (i < size && j > 0 && k > 0 && solid != (v[1] > isoLevel))
+						{
+							addQuad (mesh, cellVertices[cell-c-c*c], cellVertices[cell-c*c], cellVertices[cell], cellVertices[cell-c], !solid);
+						}
+						// edge along the y-axis
+						if (j < size && i > 0 && k > 0 && solid != (v[n] > isoLevel))
+						{
+							addQuad (mesh, cellVertices[cell-1-c*c], cellVertices[cell-1], cellVertices[cell], cellVertices[cell-c*c], !solid);
+						}
+						// edge along the z-axis
+						if (k < size && i > 0 && j > 0 && solid != (v[n*n] > isoLevel))
+						{
+							addQuad (mesh, cellVertices[cell-1-c], cellVertices[cell-c], cellVertices[cell], cellVertices[cell-1], !solid);
+						}
+					}
+				}
+			}
+		}
+
+	public:
+		ColumnJob (Pipeline3D *pipe, PipelineElement3D *element, SurfaceMesher3D *mesher, int cx, int cy, Real xDelta, Real yDelta, Real zDelta) :
+			mPipe(pipe), mElement(element), mesher(mesher), cx(cx), cy(cy), xDelta(xDelta), yDelta(yDelta), zDelta(zDelta)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			const int size = mesher->mChunkSize;
+			const int n = size + 2;
+			const int c = size + 1;
+			samples.resize (n*n*n);
+			solidCounts.resize (n);
+			cellVertices.resize (c*c*c);
+			for (int cz=0;cz<mesher->mChunkCountZ;++cz)
+			{
+				int first = 0;
+				if (cz > 0)
+				{
+					// the last two slices of the previous chunk are the first two of this chunk
+					memmove (&samples[0], &samples[size*n*n], sizeof(Real)*n*n*2);
+					solidCounts[0] = solidCounts[size];
+					solidCounts[1] = solidCounts[size+1];
+					first = 2;
+				}
+				for (int k=first;k<n;++k)
+					sampleSlice (cz, k, cache);
+				int solid = 0;
+				for (int k=0;k<n;++k)
+					solid += solidCounts[k];
+				// skips chunks without surface
+				if (solid == 0 || solid == n*n*n)
+					continue;
+				Mesh &mesh = mesher->mMeshes[(size_t(cz)*mesher->mChunkCountY + cy)*mesher->mChunkCountX + cx];
+				buildMesh (mesh, cz, cache);
+			}
+		}
+		void finish ()
+		{
+			if (mesher->mCallback)
+			{
+				mesher->mCallback->callback ();
+			}
+		}
+};
+
+SurfaceMesher3D::SurfaceMesher3D () : mModule(0), mCallback(0), mChunkSize(32), mChunkCountX(0), mChunkCountY(0), mChunkCountZ(0),
+	mLowerBoundX(0), mLowerBoundY(0), mLowerBoundZ(0), mUpperBoundX(0), mUpperBoundY(0), mUpperBoundZ(0), mIsoLevel(0), mNormalMode(NORMALS_GRADIENT)
+{
+}
+
+void SurfaceMesher3D::setModule (Module *module)
+{
+	mModule = module;
+}
+
+void SurfaceMesher3D::setCallback (BuilderCallback *callback)
+{
+	if (mCallback)
+		delete mCallback;
+	mCallback = callback;
+}
+
+void SurfaceMesher3D::setChunkSize (int size)
+{
+	NoiseAssert(size > 0, size);
+	mChunkSize = size;
+}
+
+int SurfaceMesher3D::getChunkSize () const
+{
+	return mChunkSize;
+}
+
+void SurfaceMesher3D::setChunkCount (int x, int y, int z)
+{
+	NoiseAssert(x > 0, x);
+	NoiseAssert(y > 0, y);
+	NoiseAssert(z > 0, z);
+	mChunkCountX = x;
+	mChunkCountY = y;
+	mChunkCountZ = z;
+}
+
+int SurfaceMesher3D::getChunkCountX () const
+{
+	return mChunkCountX;
+}
+
+int SurfaceMesher3D::getChunkCountY () const
+{
+	return mChunkCountY;
+}
+
+int SurfaceMesher3D::getChunkCountZ () const
+{
+	return mChunkCountZ;
+}
+
+void SurfaceMesher3D::setBounds (Real lowerBoundX, Real lowerBoundY, Real lowerBoundZ, Real upperBoundX, Real upperBoundY, Real upperBoundZ)
+{
+	mLowerBoundX = lowerBoundX;
+	mLowerBoundY = lowerBoundY;
+	mLowerBoundZ = lowerBoundZ;
+	mUpperBoundX = upperBoundX;
+	mUpperBoundY = upperBoundY;
+	mUpperBoundZ = upperBoundZ;
+}
+
+void SurfaceMesher3D::setIsoLevel (Real isoLevel)
+{
+	mIsoLevel = isoLevel;
+}
+
+Real SurfaceMesher3D::getIsoLevel () const
+{
+	return mIsoLevel;
+}
+
+void SurfaceMesher3D::setNormalMode (NormalMode mode)
+{
+	mNormalMode = mode;
+}
+
+SurfaceMesher3D::NormalMode SurfaceMesher3D::getNormalMode () const
+{
+	return mNormalMode;
+}
+
+void SurfaceMesher3D::build ()
+{
+	build(0, 0);
+}
+
+void SurfaceMesher3D::build (Pipeline3D *pipeline, PipelineElement3D *element)
+{
+	NoiseAssert(mChunkCountX > 0, mChunkCountX);
+	NoiseAssert(mChunkCountY > 0, mChunkCountY);
+	NoiseAssert(mChunkCountZ > 0, mChunkCountZ);
+	NoiseAssert(mLowerBoundX < mUpperBoundX, (mLowerBoundX, mUpperBoundX));
+	NoiseAssert(mLowerBoundY < mUpperBoundY, (mLowerBoundY, mUpperBoundY));
+	NoiseAssert(mLowerBoundZ < mUpperBoundZ, (mLowerBoundZ, mUpperBoundZ));
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline3D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	clear ();
+	mMeshes.resize (mChunkCountX*mChunkCountY*mChunkCountZ);
+
+	const Real xDelta = (mUpperBoundX - mLowerBoundX) / Real(mChunkCountX*mChunkSize);
+	const Real yDelta = (mUpperBoundY - mLowerBoundY) / Real(mChunkCountY*mChunkSize);
+	const Real zDelta = (mUpperBoundZ - mLowerBoundZ) / Real(mChunkCountZ*mChunkSize);
+	for (int y=0;y<mChunkCountY;++y)
+	{
+		for (int x=0;x<mChunkCountX;++x)
+		{
+			pipeline->addJob (new ColumnJob(pipeline, element, this, x, y, xDelta, yDelta, zDelta));
+		}
+	}
+	pipeline->executeJobs ();
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int SurfaceMesher3D::getProgressMaximum () const
+{
+	return mChunkCountX * mChunkCountY;
+}
+
+const Mesh &SurfaceMesher3D::getMesh (int x, int y, int z) const
+{
+	NoiseAssertRange (x, mChunkCountX);
+	NoiseAssertRange (y, mChunkCountY);
+	NoiseAssertRange (z, mChunkCountZ);
+	const size_t i = (size_t(z)*mChunkCountY + y)*mChunkCountX + x;
+	NoiseAssertRange (i, mMeshes.size());
+	return mMeshes[i];
+}
+
+void SurfaceMesher3D::clear ()
+{
+	mMeshes.clear ();
+}
+
+SurfaceMesher3D::~SurfaceMesher3D ()
+{
+	clear ();
+	if (mCallback)
+	{
+		delete mCallback;
+		mCallback = 0;
+	}
+}
+
+};
+};
@@ -0,0 +1,149 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISESURFACEMESHER_H
+#define NOISESURFACEMESHER_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseModule.h"
+#include "NoiseBuilders.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// A triangle mesh.
+struct Mesh
+{
+	/// Vertex positions (x, y, z).
+	std::vector<float> positions;
+	/// Vertex normals (x, y, z). Empty if normals are disabled.
+	std::vector<float> normals;
+	/// Triangle indices (counter-clockwise winding when viewed from the empty side).
+	std::vector<unsigned int> indices;
+	/// Returns the number of vertices.
+	size_t getVertexCount () const
+	{
+		return positions.size() / 3;
+	}
+	/// Returns true if the mesh has no triangles.
+	bool isEmpty () const
+	{
+		return indices.empty ();
+	}
+	/// Removes all vertices and indices.
+	void clear ()
+	{
+		positions.clear ();
+		normals.clear ();
+		indices.clear ();
+	}
+};
+
+/// Extracts the iso surface of a 3D pipeline element as triangle meshes using the surface nets algorithm.
+/// The volume is split into chunks, each chunk gets its own mesh. The density is evaluated on demand, no volume is stored.
+/// The chunks are built in parallel, each job walks a column of chunks along the z-axis and reuses the boundary samples
+/// of the previous chunk. The meshes of neighbouring chunks fit together without cracks.
+/// Samples above the iso level are treated as solid.
+class SurfaceMesher3D
+{
+	public:
+		/// Normal calculation modes.
+		enum NormalMode
+		{
+			/// No normals.
+			NORMALS_NONE=0,
+			/// Normals from central differences of the density at each vertex.
+			NORMALS_GRADIENT=1
+		};
+
+	private:
+		Module *mModule;
+		BuilderCallback *mCallback;
+		int mChunkSize;
+		int mChunkCountX, mChunkCountY, mChunkCountZ;
+		Real mLowerBoundX, mLowerBoundY, mLowerBoundZ;
+		Real mUpperBoundX, mUpperBoundY, mUpperBoundZ;
+		Real mIsoLevel;
+		NormalMode mNormalMode;
+
+		typedef std::vector<Mesh> MeshVector;
+		MeshVector mMeshes;
+
+		class ColumnJob;
+
+	public:
+		/// Constructor.
+		SurfaceMesher3D ();
+		/// Sets the source module.
+		void setModule (Module *module);
+		/// Sets the source module.
+		inline void setModule (Module &module)
+		{
+			setModule (&module);
+		}
+		/// Sets a callback. The callback will be deleted by the mesher.
+		void setCallback (BuilderCallback *callback);
+		/// Sets the number of cells along each axis of a chunk (default is 32).
+		void setChunkSize (int size);
+		/// Returns the number of cells along each axis of a chunk.
+		int getChunkSize () const;
+		/// Sets the number of chunks along each axis.
+		void setChunkCount (int x, int y, int z);
+		/// Returns the number of chunks along the x-axis.
+		int getChunkCountX () const;
+		/// Returns the number of chunks along the y-axis.
+		int getChunkCountY () const;
+		/// Returns the number of chunks along the z-axis.
+		int getChunkCountZ () const;
+		/// Sets the volume bounds.
+		void setBounds (Real lowerBoundX, Real lowerBoundY, Real lowerBoundZ, Real upperBoundX, Real upperBoundY, Real upperBoundZ);
+		/// Sets the iso level of the surface (default is 0).
+		void setIsoLevel (Real isoLevel);
+		/// Returns the iso level of the surface.
+		Real getIsoLevel () const;
+		/// Sets the normal calculation mode (default is NORMALS_GRADIENT).
+		void setNormalMode (NormalMode mode);
+		/// Returns the normal calculation mode.
+		NormalMode getNormalMode () const;
+		/// Build using the specified pipeline and element.
+		void build (Pipeline3D *pipeline, PipelineElement3D *element);
+		/// Build.
+		void build ();
+		/// Get progress maximum
+		int getProgressMaximum () const;
+		/// Returns the mesh of the specified chunk.
+		const Mesh &getMesh (int x, int y, int z) const;
+		/// Frees all meshes.
+		void clear ();
+		/// Destructor.
+		~SurfaceMesher3D ();
+};
+
+};
+};
+
+#endif // NOISESURFACEMESHER_H
@@ -30,8 +30,15 @@
 #	include "NoiseThreadedPipeline.h"
 #endif
 
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
 #if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
 #	include <unistd.h>
+#	if defined(__linux__)
+#		include <sched.h>
+#	endif
 #elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
 #	define WIN32_LEAN_AND_MEAN
 #	include <windows.h>
@@ -42,17 +49,156 @@ namespace noisepp
 namespace utils
 {
 
+#if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX && defined(__linux__)
+namespace
+{
+
+// reads the first line of a file
+bool readLine (const std::string &filename, std::string &line)
+{
+	FILE *f = fopen(filename.c_str(), "r");
+	if (!f)
+		return false;
+	char buffer[256];
+	const bool ok = fgets(buffer, sizeof(buffer), f) != NULL;
+	fclose (f);
+	if (ok)
+		line = buffer;
+	return ok;
+}
+
+// converts a quota to a number of CPUs, 0 means no limit
+int quotaToCPUs (double quota, double period)
+{
+	if (quota <= 0 || period <= 0)
+		return 0;
+	const int n = int(std::ceil(quota / period));
+	return n > 0 ? n : 1;
+}
+
+// cgroup v2: "max 100000" or "<quota> <period>"
+int readCgroup2Limit (const std::string &dir)
+{
+	std::string line;
+	if (!readLine(dir + "/cpu.max", line))
+		return -1;
+	if (line.compare(0, 3, "max") == 0)
+		return 0;
+	double quota = 0, period = 0;
+	if (sscanf(line.c_str(), "%lf %lf", &quota, &period) != 2)
+		return 0;
+	return quotaToCPUs (quota, period);
+}
+
+// cgroup v1: cpu.cfs_quota_us is -1 without a limit
+int readCgroup1Limit (const std::string &dir)
+{
+	std::string quota, period;
+	if (!readLine(dir + "/cpu.cfs_quota_us", quota) || !readLine(dir + "/cpu.cfs_period_us", period))
+		return -1;
+	return quotaToCPUs (atof(quota.c_str()), atof(period.c_str()));
+}
+
+// walks from the cgroup of the process up to the root of the hierarchy and returns the tightest limit
+int getHierarchyLimit (const std::string &mount, std::string path, bool v2)
+{
+	int limit = 0;
+	for (;;)
+	{
+		const int n = v2 ? readCgroup2Limit(mount + path) : readCgroup1Limit(mount + path);
+		if (n > 0 && (limit == 0 || n < limit))
+			limit = n;
+		if (path.empty() || path == "/")
+			break;
+		const std::string::size_type slash = path.rfind('/');
+		path = (slash == std::string::npos || slash == 0) ? std::string() : path.substr(0, slash);
+	}
+	return limit;
+}
+
+// returns the CPU limit of the cgroup quota or 0 if there is none
+int getCgroupCPULimit ()
+{
+	FILE *f = fopen("/proc/self/cgroup", "r");
+	if (!f)
+		return 0;
+	int limit = 0;
+	char buffer[1024];
+	while (fgets(buffer, sizeof(buffer), f))
+	{
+		// hierarchy-ID:controller-list:cgroup-path
+		std::string line = buffer;
+		while (!line.empty() && (line[line.size()-1] == '\n' || line[line.size()-1] == '\r'))
+			line.erase (line.size()-1);
+		const std::string::size_type first = line.find(':');
+		const std::string::size_type second = first == std::string::npos ? first : line.find(':', first+1);
+		if (second == std::string::npos)
+			continue;
+		const std::string controllers = line.substr(first+1, second-first-1);
+		const std::string path = line.substr(second+1);
+		int n = 0;
+		if (line.compare(0, first, "0") == 0 && controllers.empty())
+			n = getHierarchyLimit ("/sys/fs/cgroup", path, true);
+		else if ((","+controllers+",").find(",cpu,") != std::string::npos)
+		{
+			n = getHierarchyLimit ("/sys/fs/cgroup/cpu,cpuacct", path, false);
+			if (n == 0)
+				n = getHierarchyLimit ("/sys/fs/cgroup/cpu", path, false);
+		}
+		if (n > 0 && (limit == 0 || n < limit))
+			limit = n;
+	}
+	fclose (f);
+	return limit;
+}
+
+};
+#endif
+
 int System::mNumberOfCPUs = System::calculateNumberOfCPUs();
+bool System::mThreadPinning = getenv("NOISEPP_PIN_THREADS") != NULL && atoi(getenv("NOISEPP_PIN_THREADS")) != 0;
 
 int System::calculateNumberOfCPUs()
 {
+	const char *env = getenv("NOISEPP_NUM_THREADS");
+	if (env && atoi(env) > 0)
+		return atoi(env);
+	return detectNumberOfCPUs();
+}
+
+int System::detectNumberOfCPUs()
+{
+	int n = 1;
 #if NOISEPP_PLATFORM == NOISEPP_PLATFORM_UNIX
-	return sysconf(_SC_NPROCESSORS_ONLN);
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+#	if defined(__linux__)
+#		if defined(CPU_COUNT)
+	// the process may be restricted to some of the CPUs (taskset, cpusets)
+	cpu_set_t set;
+	CPU_ZERO (&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 0 && CPU_COUNT(&set) < n)
+		n = CPU_COUNT(&set);
+#		endif
+	// containers usually limit the CPU time with a quota instead of a CPU set
+	const int limit = getCgroupCPULimit();
+	if (limit > 0 && limit < n)
+		n = limit;
+#	endif
 #elif NOISEPP_PLATFORM == NOISEPP_PLATFORM_WINDOWS
 	SYSTEM_INFO siSysInfo;
 	GetSystemInfo(&siSysInfo);
-	return siSysInfo.dwNumberOfProcessors;
+	n = siSysInfo.dwNumberOfProcessors;
+	DWORD_PTR processMask, systemMask;
+	if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+	{
+		int count = 0;
+		for (;processMask;processMask&=processMask-1)
+			++count;
+		if (count > 0 && count < n)
+			n = count;
+	}
 #endif
+	return n > 0 ? n : 1;
 }
 
 int System::getNumberOfCPUs()
@@ -60,11 +206,26 @@ int System::getNumberOfCPUs()
 	return mNumberOfCPUs;
 }
 
+void System::setNumberOfCPUs(int n)
+{
+	mNumberOfCPUs = n > 0 ? n : calculateNumberOfCPUs();
+}
+
+void System::setThreadPinning(bool v)
+{
+	mThreadPinning = v;
+}
+
+bool System::getThreadPinning()
+{
+	return mThreadPinning;
+}
+
 Pipeline1D *System::createOptimalPipeline1D ()
 {
 #if NOISEPP_ENABLE_THREADS
 	if (mNumberOfCPUs > 1)
-		return new ThreadedPipeline1D (mNumberOfCPUs);
+		return new ThreadedPipeline1D (mNumberOfCPUs, mThreadPinning);
 #endif
 	return new Pipeline1D;
 }
@@ -73,7 +234,7 @@ Pipeline2D *System::createOptimalPipeline2D ()
 {
 #if NOISEPP_ENABLE_THREADS
 	if (mNumberOfCPUs > 1)
-		return new ThreadedPipeline2D (mNumberOfCPUs);
+		return new ThreadedPipeline2D (mNumberOfCPUs, mThreadPinning);
 #endif
 	return new Pipeline2D;
 }
@@ -82,7 +243,7 @@ Pipeline3D *System::createOptimalPipeline3D ()
 {
 #if NOISEPP_ENABLE_THREADS
 	if (mNumberOfCPUs > 1)
-		return new ThreadedPipeline3D (mNumberOfCPUs);
+		return new ThreadedPipeline3D (mNumberOfCPUs, mThreadPinning);
 #endif
 	return new Pipeline3D;
 }
@@ -91,7 +252,7 @@ JobQueue *System::createOptimalJobQueue ()
 {
 #if NOISEPP_ENABLE_THREADS
 	if (mNumberOfCPUs > 1)
-		return new ThreadedJobQueue (mNumberOfCPUs);
+		return new ThreadedJobQueue (mNumberOfCPUs, mThreadPinning);
 #endif
 	return new JobQueue;
 }
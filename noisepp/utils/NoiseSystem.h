@@ -39,7 +39,21 @@ class System
 {
 	public:
 		/// Returns the number of CPU cores avaible on the running system.
+		/// Honours the CPU affinity of the process and cgroup CPU quotas (containers), the environment
+		/// variable NOISEPP_NUM_THREADS overrides the detection.
 		static int getNumberOfCPUs();
+		/// Overrides the number of CPU cores used by the createOptimal functions, 0 restores the detected value.
+		static void setNumberOfCPUs(int n);
+		/// Returns the number of CPU cores found by the detection, ignoring overrides.
+		static int detectNumberOfCPUs();
+		/// Enables pinning the worker threads of the createOptimal functions to their own CPU.
+		/// Worker caches are created after pinning and so end up on the local memory node.
+		/// Don't enable it under a CPU quota without a cpuset (e.g. a container limited to 8 of 128 host CPUs),
+		/// the workers would be tied to CPUs shared with every other process.
+		/// The default is taken from the environment variable NOISEPP_PIN_THREADS.
+		static void setThreadPinning(bool v);
+		/// Returns whether worker threads are pinned.
+		static bool getThreadPinning();
 		/// Creates an optimal 1D pipeline using as many threads as there are CPU cores avaible.
 		static Pipeline1D *createOptimalPipeline1D ();
 		/// Creates an optimal 2D pipeline using as many threads as there are CPU cores avaible.
@@ -51,6 +65,7 @@ class System
 	protected:
 	private:
 		static int mNumberOfCPUs;
+		static bool mThreadPinning;
 		static int calculateNumberOfCPUs();
 };
 
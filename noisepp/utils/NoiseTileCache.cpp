@@ -0,0 +1,314 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseTileCache.h"
+#include "NoiseDiskTileCache.h"
+#include "NoiseBuilders.h"
+#include "NoiseSystem.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+TileCache::TileCache (size_t memoryBudget) : mMemoryBudget(memoryBudget), mMemoryUsage(0), mTileExtent(1.0), mSeed(0), mDiskCache(NULL), mHits(0), mMisses(0), mEvictions(0),
+	mPipeline(NULL), mPipelineModule(NULL), mPipelineElement(NULL)
+{
+}
+
+TileCache::~TileCache ()
+{
+	clear ();
+	delete mPipeline;
+}
+
+size_t TileCache::getEntryMemory (const Entry *entry)
+{
+	return sizeof(Entry) + entry->data.size() * sizeof(Real);
+}
+
+void TileCache::evict ()
+{
+	while (mMemoryUsage > mMemoryBudget && !mLRU.empty())
+	{
+		Entry *entry = mLRU.back ();
+		mLRU.pop_back ();
+		mEntries.erase (entry->key);
+		mMemoryUsage -= getEntryMemory (entry);
+		releaseEntry (entry);
+		++mEvictions;
+	}
+}
+
+void TileCache::releaseEntry (Entry *entry)
+{
+	// threads waiting for the entry delete it when they are done
+	entry->cached = false;
+	if (entry->waiters == 0)
+		delete entry;
+}
+
+void TileCache::buildTile (const Module &module, const TileKey &key, Real *dest)
+{
+	const Real extent = Real(ldexp (mTileExtent, key.lod));
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mBuildMutex);
+#endif
+	if (!mPipeline)
+		mPipeline = System::createOptimalPipeline2D ();
+	try
+	{
+		// the elements are only reused for the same module, shared sources may have changed for any other one
+		if (mPipelineModule != &module || mPipelineFingerprint != key.fingerprint || mPipeline->getSeed() != mSeed)
+		{
+			mPipelineModule = NULL;
+			mPipeline->clear ();
+			mPipeline->setSeed (mSeed);
+			mPipelineElement = mPipeline->getElement (module.addToPipeline(mPipeline));
+			mPipelineModule = &module;
+			mPipelineFingerprint = key.fingerprint;
+		}
+		PlaneBuilder2D builder;
+		builder.setModule (const_cast<Module&>(module));
+		builder.setSize (key.size, key.size);
+		builder.setDestination (dest);
+		builder.setBounds (extent*key.x, extent*key.y, extent*(key.x+1), extent*(key.y+1));
+		builder.build (mPipeline, mPipelineElement);
+	}
+	catch (...)
+	{
+		mPipelineModule = NULL;
+		throw;
+	}
+}
+
+void TileCache::setMemoryBudget (size_t bytes)
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	mMemoryBudget = bytes;
+	evict ();
+}
+
+size_t TileCache::getMemoryBudget () const
+{
+	return mMemoryBudget;
+}
+
+size_t TileCache::getMemoryUsage () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mMemoryUsage;
+}
+
+void TileCache::setTileExtent (Real extent)
+{
+	NoiseAssert (extent > 0, extent);
+	mTileExtent = extent;
+}
+
+Real TileCache::getTileExtent () const
+{
+	return mTileExtent;
+}
+
+void TileCache::setSeed (int seed)
+{
+	mSeed = seed;
+}
+
+int TileCache::getSeed () const
+{
+	return mSeed;
+}
+
+void TileCache::setDiskCache (DiskTileCache *diskCache)
+{
+	mDiskCache = diskCache;
+}
+
+DiskTileCache *TileCache::getDiskCache () const
+{
+	return mDiskCache;
+}
+
+bool TileCache::getTile (const Module &module, int x, int y, int size, int lod, Real *dest)
+{
+	return getTile (Fingerprint::compute(module, mSeed), module, x, y, size, lod, dest);
+}
+
+bool TileCache::getTile (const Fingerprint &fingerprint, const Module &module, int x, int y, int size, int lod, Real *dest)
+{
+	NoiseAssert (size > 0, size);
+	NoiseAssert (dest != NULL, dest);
+	const TileKey key(fingerprint, x, y, size, lod);
+	const size_t bytes = size * size * sizeof(Real);
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	for (;;)
+	{
+		EntryMap::iterator it = mEntries.find (key);
+		if (it == mEntries.end())
+			break;
+		Entry *entry = it->second;
+		if (entry->ready)
+		{
+			++mHits;
+			mLRU.splice (mLRU.begin(), mLRU, entry->lruPos);
+			memcpy (dest, &entry->data[0], bytes);
+			return true;
+		}
+#if NOISEPP_ENABLE_THREADS
+		// another thread is building the tile
+		++entry->waiters;
+		while (!entry->ready && !entry->failed)
+			mCond.wait (lk);
+		--entry->waiters;
+		const bool ready = entry->ready;
+		if (ready)
+		{
+			++mHits;
+			memcpy (dest, &entry->data[0], bytes);
+		}
+		if (!entry->cached && entry->waiters == 0)
+			delete entry;
+		if (ready)
+			return true;
+		// the build threw an exception, try again
+#else
+		break;
+#endif
+	}
+
+	++mMisses;
+	Entry *entry = new Entry;
+	entry->key = key;
+	entry->ready = false;
+	entry->failed = false;
+	entry->cached = true;
+	entry->waiters = 0;
+	mEntries.insert (std::make_pair(key, entry));
+#if NOISEPP_ENABLE_THREADS
+	lk.unlock ();
+#endif
+	try
+	{
+		entry->data.resize (size * size);
+		if (!mDiskCache || !mDiskCache->load (key, &entry->data[0]))
+		{
+			buildTile (module, key, &entry->data[0]);
+			if (mDiskCache)
+				mDiskCache->store (key, &entry->data[0]);
+		}
+	}
+	catch (...)
+	{
+#if NOISEPP_ENABLE_THREADS
+		lk.lock ();
+#endif
+		mEntries.erase (key);
+		entry->failed = true;
+		releaseEntry (entry);
+#if NOISEPP_ENABLE_THREADS
+		mCond.notifyAll ();
+#endif
+		throw;
+	}
+#if NOISEPP_ENABLE_THREADS
+	lk.lock ();
+#endif
+	memcpy (dest, &entry->data[0], bytes);
+	entry->ready = true;
+	mLRU.push_front (entry);
+	entry->lruPos = mLRU.begin ();
+	mMemoryUsage += getEntryMemory (entry);
+#if NOISEPP_ENABLE_THREADS
+	mCond.notifyAll ();
+#endif
+	evict ();
+	return false;
+}
+
+bool TileCache::contains (const TileKey &key) const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	EntryMap::const_iterator it = mEntries.find (key);
+	return it != mEntries.end() && it->second->ready;
+}
+
+void TileCache::clear ()
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	for (EntryList::iterator it=mLRU.begin();it!=mLRU.end();++it)
+	{
+		mEntries.erase ((*it)->key);
+		releaseEntry (*it);
+	}
+	mLRU.clear ();
+	mMemoryUsage = 0;
+}
+
+unsigned long TileCache::getHitCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mHits;
+}
+
+unsigned long TileCache::getMissCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mMisses;
+}
+
+unsigned long TileCache::getEvictionCount () const
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	return mEvictions;
+}
+
+void TileCache::resetStatistics ()
+{
+#if NOISEPP_ENABLE_THREADS
+	threadpp::Mutex::Lock lk(mMutex);
+#endif
+	mHits = mMisses = mEvictions = 0;
+}
+
+};
+};
@@ -0,0 +1,189 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISETILECACHE_H
+#define NOISETILECACHE_H
+
+#include <list>
+
+#include "NoisePrerequisites.h"
+#include "NoiseModule.h"
+#include "NoiseFingerprint.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+class DiskTileCache;
+
+/// Key of a cached tile.
+struct TileKey
+{
+	/// Fingerprint of the module graph.
+	Fingerprint fingerprint;
+	/// Tile coordinates.
+	int x, y;
+	/// Number of samples in each direction.
+	int size;
+	/// Level of detail, each level doubles the area covered by a tile.
+	int lod;
+
+	/// Constructor.
+	TileKey () : x(0), y(0), size(0), lod(0)
+	{}
+	/// Constructor.
+	TileKey (const Fingerprint &fingerprint, int x, int y, int size, int lod) : fingerprint(fingerprint), x(x), y(y), size(size), lod(lod)
+	{}
+	bool operator== (const TileKey &other) const
+	{
+		return x == other.x && y == other.y && size == other.size && lod == other.lod && fingerprint == other.fingerprint;
+	}
+	bool operator< (const TileKey &other) const
+	{
+		if (x != other.x)
+			return x < other.x;
+		if (y != other.y)
+			return y < other.y;
+		if (size != other.size)
+			return size < other.size;
+		if (lod != other.lod)
+			return lod < other.lod;
+		return fingerprint < other.fingerprint;
+	}
+};
+
+/// Thread-safe in-memory cache for tiles built with PlaneBuilder2D.
+/// Tiles are identified by the fingerprint of the module graph, the tile coordinates, the tile size and the level of detail.
+/// Tile (x, y) at level of detail lod covers the plane from (x*e, y*e) to ((x+1)*e, (y+1)*e) with e = tileExtent * 2^lod.
+/// If the memory used by the tiles exceeds the budget, the least recently used tiles are dropped.
+/// Concurrent requests for the same missing tile build it only once, the other threads wait for the result.
+/// Missing tiles are built one at a time with a single pipeline owned by the cache, its elements are kept as long as the same module graph is requested.
+/// A DiskTileCache can be attached as second tier.
+class TileCache
+{
+	private:
+		struct Entry
+		{
+			TileKey key;
+			std::vector<Real> data;
+			bool ready;
+			bool failed;
+			bool cached;
+			int waiters;
+			std::list<Entry*>::iterator lruPos;
+		};
+		typedef std::map<TileKey, Entry*> EntryMap;
+		typedef std::list<Entry*> EntryList;
+
+		EntryMap mEntries;
+		// ready entries, most recently used first
+		EntryList mLRU;
+		size_t mMemoryBudget;
+		size_t mMemoryUsage;
+		Real mTileExtent;
+		int mSeed;
+		DiskTileCache *mDiskCache;
+		unsigned long mHits, mMisses, mEvictions;
+		// pipeline used to build the tiles and the module its elements were created for
+		Pipeline2D *mPipeline;
+		const Module *mPipelineModule;
+		Fingerprint mPipelineFingerprint;
+		PipelineElement2D *mPipelineElement;
+#if NOISEPP_ENABLE_THREADS
+		mutable threadpp::Mutex mMutex;
+		threadpp::Condition mCond;
+		// serializes the builds using mPipeline
+		threadpp::Mutex mBuildMutex;
+#endif
+
+		static size_t getEntryMemory (const Entry *entry);
+		void evict ();
+		void releaseEntry (Entry *entry);
+		void buildTile (const Module &module, const TileKey &key, Real *dest);
+
+		TileCache (const TileCache &);
+		TileCache &operator= (const TileCache &);
+	public:
+		/// Constructor.
+		/// @param memoryBudget The maximum memory used by the cached tiles in bytes.
+		TileCache (size_t memoryBudget=64*1024*1024);
+		/// Destructor.
+		~TileCache ();
+
+		/// Sets the maximum memory used by the cached tiles in bytes.
+		void setMemoryBudget (size_t bytes);
+		/// Returns the maximum memory used by the cached tiles in bytes.
+		size_t getMemoryBudget () const;
+		/// Returns the memory currently used by the cached tiles in bytes.
+		size_t getMemoryUsage () const;
+		/// Sets the size of a tile at level of detail 0 in plane coordinates.
+		void setTileExtent (Real extent);
+		/// Returns the size of a tile at level of detail 0 in plane coordinates.
+		Real getTileExtent () const;
+		/// Sets the master seed used to build the tiles (see Pipeline::setSeed()).
+		void setSeed (int seed);
+		/// Returns the master seed used to build the tiles.
+		int getSeed () const;
+		/// Sets a disk cache used as second tier.
+		/// Missing tiles are loaded from the disk cache if possible, built tiles are stored there.
+		/// The disk cache is not owned by the tile cache, pass NULL to disable it.
+		void setDiskCache (DiskTileCache *diskCache);
+		/// Returns the disk cache.
+		DiskTileCache *getDiskCache () const;
+
+		/// Copies a tile to the destination, the tile is built first if it isn't cached.
+		/// @param module The source module.
+		/// @param x The x-coordinate of the tile.
+		/// @param y The y-coordinate of the tile.
+		/// @param size The number of samples in each direction.
+		/// @param lod The level of detail.
+		/// @param dest The destination, it must hold size*size values.
+		/// @return true if the tile was found in the cache.
+		bool getTile (const Module &module, int x, int y, int size, int lod, Real *dest);
+		/// Copies a tile to the destination, the tile is built first if it isn't cached.
+		/// Use this function to avoid computing the fingerprint for every request.
+		/// The fingerprint must be computed with the seed set by setSeed().
+		/// @copydetails getTile(const Module &, int, int, int, int, Real *)
+		bool getTile (const Fingerprint &fingerprint, const Module &module, int x, int y, int size, int lod, Real *dest);
+		/// Returns true if the tile is cached.
+		bool contains (const TileKey &key) const;
+		/// Removes all cached tiles.
+		void clear ();
+
+		/// Returns the number of requests served from the cache.
+		unsigned long getHitCount () const;
+		/// Returns the number of requests that had to build the tile.
+		unsigned long getMissCount () const;
+		/// Returns the number of tiles dropped to stay within the memory budget.
+		unsigned long getEvictionCount () const;
+		/// Resets the hit, miss and eviction counters.
+		void resetStatistics ();
+};
+
+};
+};
+
+#endif // NOISETILECACHE_H
@@ -0,0 +1,146 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseTraceWriter.h"
+#include "NoiseOutStream.h"
+
+#include <cstdio>
+
+namespace noisepp
+{
+namespace utils
+{
+
+struct TraceEvent
+{
+	JobTracer::Event event;
+	int thread;
+	bool operator< (const TraceEvent &other) const
+	{
+		return event.time < other.event.time;
+	}
+};
+
+static void writeEvent (std::string &str, const char *name, const char *category, const char *phase, int thread, double ts, double dur, const void *job, unsigned long id)
+{
+	char buffer[256];
+	int len = sprintf (buffer, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", name, category, phase, thread, ts);
+	if (dur >= 0)
+		len += sprintf (buffer + len, ",\"dur\":%.3f", dur);
+	if (id)
+		len += sprintf (buffer + len, ",\"id\":%lu", id);
+	if (job)
+		len += sprintf (buffer + len, ",\"args\":{\"job\":\"%p\"}", job);
+	sprintf (buffer + len, "}");
+	str += buffer;
+}
+
+std::string TraceWriter::toChromeTrace (const JobTracer &tracer)
+{
+	std::string str = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"noisepp\"}}";
+	char buffer[256];
+	std::vector<TraceEvent> events;
+	std::vector<JobTracer::Event> threadEvents;
+	for (size_t i=0;i<tracer.getThreadCount();++i)
+	{
+		const JobTracer::ThreadBuffer *thread = tracer.getThread (i);
+		sprintf (buffer, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", int(i+1), thread->getName().c_str());
+		str += buffer;
+		thread->getEvents (threadEvents);
+		for (size_t j=0;j<threadEvents.size();++j)
+		{
+			TraceEvent e;
+			e.event = threadEvents[j];
+			e.thread = int(i+1);
+			events.push_back (e);
+		}
+	}
+	std::stable_sort (events.begin(), events.end());
+	const double start = events.empty() ? 0.0 : events.front().event.time;
+
+	// open begin events, keyed by thread and job
+	typedef std::map<std::pair<int, const void*>, double> OpenMap;
+	OpenMap open;
+	// enqueued jobs waiting for a worker
+	typedef std::map<const void*, std::pair<int, unsigned long> > QueueMap;
+	QueueMap queued;
+	unsigned long nextID = 0;
+	for (size_t i=0;i<events.size();++i)
+	{
+		const JobTracer::Event &e = events[i].event;
+		const int thread = events[i].thread;
+		const double ts = (e.time - start) * 1e6;
+		switch (e.type)
+		{
+			case JobTracer::EVENT_ENQUEUE:
+				queued[e.job] = std::make_pair (thread, ++nextID);
+				writeEvent (str, "queued", "queue", "b", thread, ts, -1, e.job, nextID);
+				break;
+			case JobTracer::EVENT_EXECUTE_BEGIN:
+			{
+				QueueMap::iterator it = queued.find (e.job);
+				if (it != queued.end())
+				{
+					writeEvent (str, "queued", "queue", "e", it->second.first, ts, -1, NULL, it->second.second);
+					queued.erase (it);
+				}
+			}
+			// fall through
+			case JobTracer::EVENT_FINISH_BEGIN:
+			case JobTracer::EVENT_WAIT_BEGIN:
+				open[std::make_pair(thread, e.job)] = ts;
+				break;
+			case JobTracer::EVENT_EXECUTE_END:
+			case JobTracer::EVENT_FINISH_END:
+			case JobTracer::EVENT_WAIT_END:
+			{
+				OpenMap::iterator it = open.find (std::make_pair(thread, e.job));
+				if (it == open.end())
+					break;
+				const char *name = e.type == JobTracer::EVENT_EXECUTE_END ? "execute" : (e.type == JobTracer::EVENT_FINISH_END ? "finish" : "wait");
+				const char *category = e.type == JobTracer::EVENT_WAIT_END ? "executor" : "job";
+				writeEvent (str, name, category, "X", thread, it->second, ts - it->second, e.job, 0);
+				open.erase (it);
+				break;
+			}
+		}
+	}
+	str += "\n]}\n";
+	return str;
+}
+
+bool TraceWriter::save (const JobTracer &tracer, const std::string &filename)
+{
+	FileOutStream stream(filename);
+	if (!stream.isOpen())
+		return false;
+	const std::string str = toChromeTrace (tracer);
+	stream.write (str.data(), str.size());
+	stream.close ();
+	return true;
+}
+
+};
+};
@@ -0,0 +1,54 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISETRACEWRITER_H
+#define NOISETRACEWRITER_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseJobTracer.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// Exports the events of a JobTracer in the Chrome trace event format (JSON).
+/// The files can be viewed in chrome://tracing or Perfetto. Job execution and finish() callbacks are shown as slices on
+/// the thread that ran them, the time the main thread spent waiting for workers as "wait" slices and the time each job
+/// spent in the queue as asynchronous "queued" spans.
+class TraceWriter
+{
+	public:
+		/// Returns the trace as JSON string.
+		static std::string toChromeTrace (const JobTracer &tracer);
+		/// Writes the trace to a file.
+		/// Returns false if the file couldn't be opened.
+		static bool save (const JobTracer &tracer, const std::string &filename);
+};
+
+};
+};
+
+#endif // NOISETRACEWRITER_H
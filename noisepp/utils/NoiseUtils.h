@@ -31,17 +31,32 @@
 #endif
 
 #define NOISE_FILE_VERSION 1
+#define NOISE_FILE_VERSION_MAPPED 2
+#define NOISE_MAPPED_HEADER_SIZE 32
+#define NOISE_MAPPED_ENTRY_SIZE 16
 
 #include "NoiseEndianUtils.h"
 #include "NoiseInStream.h"
 #include "NoiseOutStream.h"
 #include "NoiseWriter.h"
 #include "NoiseReader.h"
+#include "NoiseMappedFile.h"
+#include "NoisePipelineFile.h"
 #include "NoiseColourValue.h"
 #include "NoiseImage.h"
+#include "NoiseImageEncoder.h"
+#include "NoiseHeightfield.h"
+#include "NoiseFingerprint.h"
+#include "NoiseProfileReport.h"
 #include "NoiseSystem.h"
 #include "NoiseJobQueue.h"
+#include "NoiseTraceWriter.h"
 #include "NoiseGradientRenderer.h"
+#include "NoiseLightRenderer.h"
 #include "NoiseBuilders.h"
+#include "NoiseTileCache.h"
+#include "NoiseDiskTileCache.h"
+#include "NoiseVolumeBuilder.h"
+#include "NoiseSurfaceMesher.h"
 
 #endif // NOISEUTILS_H
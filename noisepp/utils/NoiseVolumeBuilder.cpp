@@ -0,0 +1,283 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "NoiseVolumeBuilder.h"
+#include "NoiseSystem.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+class VolumeBuilder3D::ChunkJob : public PipelineJob
+{
+	private:
+		Pipeline3D *mPipe;
+		PipelineElement3D *mElement;
+		VolumeBuilder3D *builder;
+		VolumeChunk *chunk;
+		Real x, y, z;
+		Real xDelta, yDelta, zDelta;
+
+	public:
+		ChunkJob (Pipeline3D *pipe, PipelineElement3D *element, VolumeBuilder3D *builder, VolumeChunk *chunk, Real x, Real y, Real z, Real xDelta, Real yDelta, Real zDelta) :
+			mPipe(pipe), mElement(element), builder(builder), chunk(chunk), x(x), y(y), z(z), xDelta(xDelta), yDelta(yDelta), zDelta(zDelta)
+		{
+		}
+		void execute (Cache *cache)
+		{
+			const int size = builder->mChunkSize;
+			const Real isoLevel = builder->mIsoLevel;
+			Real *data = new Real[size*size*size];
+			Real *buffer = data;
+			int solidCount = 0;
+			// builds the chunk slice by slice
+			for (int k=0;k<size;++k)
+			{
+				const Real zp = z + zDelta*k;
+				for (int j=0;j<size;++j)
+				{
+					const Real yp = y + yDelta*j;
+					for (int i=0;i<size;++i)
+					{
+						mPipe->cleanCache (cache);
+						const Real value = mElement->getValue(x + xDelta*i, yp, zp, cache);
+						if (value > isoLevel)
+							++solidCount;
+						*buffer++ = value;
+					}
+				}
+			}
+			// only keeps the data if the chunk contains the surface
+			if (solidCount == 0 || solidCount == size*size*size)
+			{
+				delete[] data;
+				chunk->state = (solidCount == 0) ? CHUNK_EMPTY : CHUNK_SOLID;
+			}
+			else
+			{
+				chunk->data = data;
+				chunk->state = CHUNK_DENSE;
+			}
+		}
+		void finish ()
+		{
+			if (builder->mCallback)
+			{
+				builder->mCallback->callback ();
+			}
+		}
+};
+
+VolumeBuilder3D::VolumeBuilder3D () : mModule(0), mCallback(0), mFilter(0), mChunkSize(32), mChunkCountX(0), mChunkCountY(0), mChunkCountZ(0),
+	mLowerBoundX(0), mLowerBoundY(0), mLowerBoundZ(0), mUpperBoundX(0), mUpperBoundY(0), mUpperBoundZ(0), mIsoLevel(0)
+{
+}
+
+void VolumeBuilder3D::setModule (Module *module)
+{
+	mModule = module;
+}
+
+void VolumeBuilder3D::setCallback (BuilderCallback *callback)
+{
+	if (mCallback)
+		delete mCallback;
+	mCallback = callback;
+}
+
+void VolumeBuilder3D::setFilter (VolumeChunkFilter *filter)
+{
+	if (mFilter)
+		delete mFilter;
+	mFilter = filter;
+}
+
+void VolumeBuilder3D::setChunkSize (int size)
+{
+	NoiseAssert(size > 0, size);
+	mChunkSize = size;
+}
+
+int VolumeBuilder3D::getChunkSize () const
+{
+	return mChunkSize;
+}
+
+void VolumeBuilder3D::setChunkCount (int x, int y, int z)
+{
+	NoiseAssert(x > 0, x);
+	NoiseAssert(y > 0, y);
+	NoiseAssert(z > 0, z);
+	mChunkCountX = x;
+	mChunkCountY = y;
+	mChunkCountZ = z;
+}
+
+int VolumeBuilder3D::getChunkCountX () const
+{
+	return mChunkCountX;
+}
+
+int VolumeBuilder3D::getChunkCountY () const
+{
+	return mChunkCountY;
+}
+
+int VolumeBuilder3D::getChunkCountZ () const
+{
+	return mChunkCountZ;
+}
+
+void VolumeBuilder3D::setBounds (Real lowerBoundX, Real lowerBoundY, Real lowerBoundZ, Real upperBoundX, Real upperBoundY, Real upperBoundZ)
+{
+	mLowerBoundX = lowerBoundX;
+	mLowerBoundY = lowerBoundY;
+	mLowerBoundZ = lowerBoundZ;
+	mUpperBoundX = upperBoundX;
+	mUpperBoundY = upperBoundY;
+	mUpperBoundZ = upperBoundZ;
+}
+
+void VolumeBuilder3D::setIsoLevel (Real isoLevel)
+{
+	mIsoLevel = isoLevel;
+}
+
+Real VolumeBuilder3D::getIsoLevel () const
+{
+	return mIsoLevel;
+}
+
+void VolumeBuilder3D::build ()
+{
+	build(0, 0);
+}
+
+void VolumeBuilder3D::build (Pipeline3D *pipeline, PipelineElement3D *element)
+{
+	NoiseAssert(mChunkCountX > 0, mChunkCountX);
+	NoiseAssert(mChunkCountY > 0, mChunkCountY);
+	NoiseAssert(mChunkCountZ > 0, mChunkCountZ);
+	NoiseAssert(mLowerBoundX < mUpperBoundX, (mLowerBoundX, mUpperBoundX));
+	NoiseAssert(mLowerBoundY < mUpperBoundY, (mLowerBoundY, mUpperBoundY));
+	NoiseAssert(mLowerBoundZ < mUpperBoundZ, (mLowerBoundZ, mUpperBoundZ));
+
+	bool destroyPipe = false;
+	if (!pipeline)
+	{
+		NoiseAssert(mModule != NULL, mModule);
+		pipeline = System::createOptimalPipeline3D();
+		ElementID id = mModule->addToPipeline(pipeline);
+		element = pipeline->getElement(id);
+		destroyPipe = true;
+	}
+
+	clear ();
+	mChunks.resize (mChunkCountX*mChunkCountY*mChunkCountZ);
+
+	const Real xDelta = (mUpperBoundX - mLowerBoundX) / Real(mChunkCountX*mChunkSize);
+	const Real yDelta = (mUpperBoundY - mLowerBoundY) / Real(mChunkCountY*mChunkSize);
+	const Real zDelta = (mUpperBoundZ - mLowerBoundZ) / Real(mChunkCountZ*mChunkSize);
+	VolumeChunk *chunk = &mChunks[0];
+	for (int z=0;z<mChunkCountZ;++z)
+	{
+		for (int y=0;y<mChunkCountY;++y)
+		{
+			for (int x=0;x<mChunkCountX;++x)
+			{
+				VolumeChunkState state = CHUNK_DENSE;
+				if (mFilter)
+					state = mFilter->classify (x, y, z);
+				if (state == CHUNK_DENSE)
+				{
+					pipeline->addJob (new ChunkJob(pipeline, element, this, chunk,
+						mLowerBoundX + xDelta*(x*mChunkSize), mLowerBoundY + yDelta*(y*mChunkSize), mLowerBoundZ + zDelta*(z*mChunkSize),
+						xDelta, yDelta, zDelta));
+				}
+				else
+				{
+					chunk->state = state;
+					if (mCallback)
+						mCallback->callback ();
+				}
+				++chunk;
+			}
+		}
+	}
+	pipeline->executeJobs ();
+
+	if (destroyPipe)
+	{
+		delete pipeline;
+		pipeline = 0;
+	}
+}
+
+int VolumeBuilder3D::getProgressMaximum () const
+{
+	return mChunkCountX * mChunkCountY * mChunkCountZ;
+}
+
+const VolumeChunk &VolumeBuilder3D::getChunk (int x, int y, int z) const
+{
+	NoiseAssertRange (x, mChunkCountX);
+	NoiseAssertRange (y, mChunkCountY);
+	NoiseAssertRange (z, mChunkCountZ);
+	const size_t i = (size_t(z)*mChunkCountY + y)*mChunkCountX + x;
+	NoiseAssertRange (i, mChunks.size());
+	return mChunks[i];
+}
+
+void VolumeBuilder3D::clear ()
+{
+	for (ChunkVector::iterator it=mChunks.begin();it!=mChunks.end();++it)
+	{
+		if (it->data)
+		{
+			delete[] it->data;
+			it->data = 0;
+		}
+	}
+	mChunks.clear ();
+}
+
+VolumeBuilder3D::~VolumeBuilder3D ()
+{
+	clear ();
+	if (mCallback)
+	{
+		delete mCallback;
+		mCallback = 0;
+	}
+	if (mFilter)
+	{
+		delete mFilter;
+		mFilter = 0;
+	}
+}
+
+};
+};
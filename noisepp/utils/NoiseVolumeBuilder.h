@@ -0,0 +1,150 @@
+// Noise++ Library
+// Copyright (c) 2008, Urs C. Hanselmann
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright notice,
+//      this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright notice,
+//      this list of conditions and the following disclaimer in the documentation
+//      and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef NOISEVOLUMEBUILDER_H
+#define NOISEVOLUMEBUILDER_H
+
+#include "NoisePrerequisites.h"
+#include "NoiseModule.h"
+#include "NoiseBuilders.h"
+
+namespace noisepp
+{
+namespace utils
+{
+
+/// State of a volume chunk.
+enum VolumeChunkState
+{
+	/// The chunk contains sample data.
+	CHUNK_DENSE=0,
+	/// All samples of the chunk are above the iso level.
+	CHUNK_SOLID=1,
+	/// All samples of the chunk are below or equal to the iso level.
+	CHUNK_EMPTY=2,
+	/// The chunk was not built.
+	CHUNK_SKIPPED=3
+};
+
+/// A chunk of a volume.
+struct VolumeChunk
+{
+	/// The chunk state.
+	VolumeChunkState state;
+	/// The sample data (only set if the state is CHUNK_DENSE).
+	/// The samples are stored in z-slices, the x-coordinate changes fastest.
+	Real *data;
+	/// Constructor.
+	VolumeChunk () : state(CHUNK_SKIPPED), data(0) {}
+};
+
+/// Volume chunk filter class.
+/// Overwrite the classify() function to tell the builder which chunks are required.
+class VolumeChunkFilter
+{
+	public:
+		/// Called in the main thread for each chunk before building.
+		/// Return CHUNK_DENSE to build the chunk, CHUNK_SKIPPED to ignore it or CHUNK_SOLID / CHUNK_EMPTY
+		/// if the state of the chunk is already known without sampling it.
+		/// @param x The x-index of the chunk.
+		/// @param y The y-index of the chunk.
+		/// @param z The z-index of the chunk.
+		virtual VolumeChunkState classify (int x, int y, int z) = 0;
+		/// Destructor.
+		virtual ~VolumeChunkFilter ()
+		{}
+};
+
+/// Builder class for a 3D volume (e.g. a density field for voxel terrain).
+/// The volume is split into cubic chunks which are built in parallel. Chunks where all samples are on the same side of the
+/// iso level are only stored as a CHUNK_SOLID or CHUNK_EMPTY flag, so volumes mostly consisting of solid ground and air
+/// need only little memory. A VolumeChunkFilter can be used to skip chunks which are not required.
+class VolumeBuilder3D
+{
+	private:
+		Module *mModule;
+		BuilderCallback *mCallback;
+		VolumeChunkFilter *mFilter;
+		int mChunkSize;
+		int mChunkCountX, mChunkCountY, mChunkCountZ;
+		Real mLowerBoundX, mLowerBoundY, mLowerBoundZ;
+		Real mUpperBoundX, mUpperBoundY, mUpperBoundZ;
+		Real mIsoLevel;
+
+		typedef std::vector<VolumeChunk> ChunkVector;
+		ChunkVector mChunks;
+
+		class ChunkJob;
+
+	public:
+		/// Constructor.
+		VolumeBuilder3D ();
+		/// Sets the source module.
+		void setModule (Module *module);
+		/// Sets the source module.
+		inline void setModule (Module &module)
+		{
+			setModule (&module);
+		}
+		/// Sets a callback. The callback will be deleted by the builder.
+		void setCallback (BuilderCallback *callback);
+		/// Sets a chunk filter. The filter will be deleted by the builder.
+		void setFilter (VolumeChunkFilter *filter);
+		/// Sets the number of samples along each axis of a chunk (default is 32).
+		void setChunkSize (int size);
+		/// Returns the number of samples along each axis of a chunk.
+		int getChunkSize () const;
+		/// Sets the number of chunks along each axis.
+		void setChunkCount (int x, int y, int z);
+		/// Returns the number of chunks along the x-axis.
+		int getChunkCountX () const;
+		/// Returns the number of chunks along the y-axis.
+		int getChunkCountY () const;
+		/// Returns the number of chunks along the z-axis.
+		int getChunkCountZ () const;
+		/// Sets the volume bounds.
+		void setBounds (Real lowerBoundX, Real lowerBoundY, Real lowerBoundZ, Real upperBoundX, Real upperBoundY, Real upperBoundZ);
+		/// Sets the iso level which separates solid (above) from empty (below or equal) samples (default is 0).
+		void setIsoLevel (Real isoLevel);
+		/// Returns the iso level.
+		Real getIsoLevel () const;
+		/// Build using the specified pipeline and element.
+		void build (Pipeline3D *pipeline, PipelineElement3D *element);
+		/// Build.
+		void build ();
+		/// Get progress maximum
+		int getProgressMaximum () const;
+		/// Returns the specified chunk.
+		const VolumeChunk &getChunk (int x, int y, int z) const;
+		/// Frees all chunks.
+		void clear ();
+		/// Destructor.
+		~VolumeBuilder3D ();
+};
+
+};
+};
+
+#endif // NOISEVOLUMEBUILDER_H
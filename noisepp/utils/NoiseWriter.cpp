@@ -102,5 +102,85 @@ void Writer::writePipeline ()
 		writeModuleRel(*it);
 }
 
+void Writer::writeMappedPipeline ()
+{
+	NoiseAssert (!mModuleVec.empty(), mModuleVec);
+	NoiseAssert (mModuleCount == mModules.size(), mModuleCount);
+	NoiseAssert (mModuleCount == mModuleVec.size(), mModuleCount);
+
+	const unsigned count = mModuleCount;
+	// the parameters are written with the module's own write() function
+	std::vector<MemoryOutStream*> params;
+	unsigned linkCount = 0;
+	for (ModuleVector::iterator it=mModuleVec.begin();it!=mModuleVec.end();++it)
+	{
+		MemoryOutStream *block = new MemoryOutStream;
+		(*it)->write (*block);
+		params.push_back (block);
+		linkCount += (unsigned)(*it)->getSourceModuleCount();
+	}
+	const unsigned tableOffset = NOISE_MAPPED_HEADER_SIZE;
+	const unsigned linkOffset = tableOffset + count * NOISE_MAPPED_ENTRY_SIZE;
+	const unsigned dataOffset = (linkOffset + linkCount * 4 + 7) & ~7;
+	unsigned fileSize = dataOffset;
+	std::vector<unsigned> paramOffsets;
+	for (unsigned i=0;i<count;++i)
+	{
+		paramOffsets.push_back (fileSize);
+		fileSize += ((unsigned)params[i]->tell() + 7) & ~7;
+	}
+
+	// header
+	unsigned char ver = NOISE_FILE_VERSION_MAPPED;
+	mStream.write (ver);
+	mStream.write ("NPP", 3);
+	mStream.write (count);
+	mStream.write (tableOffset);
+	mStream.write (linkOffset);
+	mStream.write (dataOffset);
+	mStream.write (fileSize);
+	unsigned reserved = 0;
+	mStream.write (reserved);
+	mStream.write (reserved);
+
+	// module table
+	unsigned firstLink = 0;
+	for (unsigned i=0;i<count;++i)
+	{
+		const Module *module = mModuleVec[i];
+		unsigned short typeID = module->getType();
+		mStream.write (typeID);
+		unsigned short sourceCount = (unsigned short)module->getSourceModuleCount();
+		mStream.write (sourceCount);
+		mStream.write (firstLink);
+		mStream.write (paramOffsets[i]);
+		unsigned paramSize = (unsigned)params[i]->tell();
+		mStream.write (paramSize);
+		firstLink += sourceCount;
+	}
+
+	// module relations
+	for (ModuleVector::iterator it=mModuleVec.begin();it!=mModuleVec.end();++it)
+	{
+		for (size_t i=0;i<(*it)->getSourceModuleCount();++i)
+		{
+			unsigned id = getModuleID((*it)->getSourceModule(i));
+			mStream.write (id);
+		}
+	}
+
+	// parameter blocks, 8 byte aligned
+	const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	mStream.write (padding, dataOffset - (linkOffset + linkCount * 4));
+	for (unsigned i=0;i<count;++i)
+	{
+		const size_t size = params[i]->tell();
+		if (size)
+			mStream.write (params[i]->getBuffer(), size);
+		mStream.write (padding, ((size + 7) & ~7) - size);
+		delete params[i];
+	}
+}
+
 };
 };
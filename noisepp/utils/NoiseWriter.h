@@ -63,9 +63,24 @@ class Writer
 		{ return addModule (&module); }
 		/// Returns the ID of the specified module (the module must be added before)
 		unsigned short getModuleID (const Module *module);
+		/// Returns the module with the specified ID.
+		const Module *getModule (unsigned short id) const
+		{
+			NoiseAssertRange (id, mModuleVec.size());
+			return mModuleVec[id];
+		}
+		/// Returns the number of added modules.
+		unsigned short getModuleCount () const
+		{
+			return mModuleCount;
+		}
 
 		/// Writes the final pipeline to the stream specified in the constructor.
 		void writePipeline ();
+		/// Writes the final pipeline in the NOISE_FILE_VERSION_MAPPED format.
+		/// The file contains a module table and aligned parameter blocks, it can be loaded from memory (see MappedFile)
+		/// without parsing the whole file.
+		void writeMappedPipeline ();
 };
 
 };